@@ -26,29 +26,28 @@
 // # are relative to the DS39662E
 // #E are relative to the DS80349C
 
-#include <SearchAThing.Arduino.Utils\DebugMacros.h>
+#include <SearchAThing.Arduino.Utils/DebugMacros.h>
 
 #include "Driver.h"
 
 #include <MemoryFree/MemoryFree.h>
 #include <SPI.h>
 
-#include <SearchAThing.Arduino.Utils\Util.h>
-#include <SearchAThing.Arduino.Utils\SList.h>
-#include <SearchAThing.Arduino.Utils\RamData.h>
+#include <SearchAThing.Arduino.Utils/Util.h>
+#include <SearchAThing.Arduino.Utils/SList.h>
+#include <SearchAThing.Arduino.Utils/RamData.h>
 using namespace SearchAThing::Arduino;
 
-#include <SearchAThing.Arduino.Net\Protocol.h>
-#include <SearchAThing.Arduino.Net\ARP.h>
-#include <SearchAThing.Arduino.Net\Checksum.h>
-#include <SearchAThing.Arduino.Net\ICMP.h>
-#include <SearchAThing.Arduino.Net\DHCP.h>
+#include <SearchAThing.Arduino.Net/Protocol.h>
+#include <SearchAThing.Arduino.Net/ARP.h>
+#include <SearchAThing.Arduino.Net/Checksum.h>
+#include <SearchAThing.Arduino.Net/ICMP.h>
+#include <SearchAThing.Arduino.Net/DHCP.h>
 using namespace SearchAThing::Arduino::Net;
 
-SPISettings SPI_SETTINGS(20e6, MSBFIRST, SPI_MODE0);
-
-#define SPI_BEGIN()	{ SPI.beginTransaction(SPI_SETTINGS); digitalWrite(DPIN_CS, LOW); }
-#define SPI_END()	{ digitalWrite(DPIN_CS, HIGH); SPI.endTransaction(); }
+// waits the asynchronous transfer holding the bus, if any ( of any driver )
+#define SPI_BEGIN()	{ if (xferDriver != NULL) xferDriver->WaitTransfer(); ++stats.spiTransactions; spi->Select(); }
+#define SPI_END()	spi->Deselect()
 
 namespace SearchAThing
 {
@@ -60,19 +59,197 @@ namespace SearchAThing
 		{
 
 			// #4.2.1
-			void Driver::InitSPI()
+			// #2.2
+			static bool ValidRevId(byte revId)
 			{
-				pinMode(DPIN_CS, OUTPUT);
-				SPI.begin();
+				return
+					revId == B10 || // B1
+					revId == B100 || // B4
+					revId == B101 || // B5 
+					revId == B110; // B7
 			}
 
-			// #2.2
-			void Driver::WaitAfterPoweron()
+			// controller left running by a previous run with the same MAC and
+			// layout : resumed with the init script replayed, the tx logic reset
+			// and, unless RestartWarmKeepRx, the rx ring flushed
+			bool Driver::WarmRestart()
+			{
+				// bank shadow from the chip
+				ReadControlRegister(ETH_ECON1);
+
+				if (!(econ1 & ETH_ECON1_RXEN) || !ValidRevId(RevId())) return false;
+
+				if (ReadControlRegister(ETH_ERXSTL) != lowByte(ETH_RX_BEGIN) ||
+					ReadControlRegister(ETH_ERXSTH) != highByte(ETH_RX_BEGIN) ||
+					ReadControlRegister(ETH_ERXNDL) != lowByte(rxEnd) ||
+					ReadControlRegister(ETH_ERXNDH) != highByte(rxEnd))
+					return false;
+
+				const byte maadr[] = { ETH_MAADR1, ETH_MAADR2, ETH_MAADR3, ETH_MAADR4, ETH_MAADR5, ETH_MAADR6 };
+				for (byte i = 0; i < 6; ++i)
+					if (ReadControlRegister(maadr[i]) != macAddress.Buf()[i]) return false;
+
+#if defined DEBUG && defined DEBUG_ETH_DRIVER
+				DPrint(F("ETH warm restart")); DNewline();
+#endif
+
+				WriteControlRegister(ETH_EIE, 0);
+
+				// multicast groups of the previous run : the join table starts
+				// empty after an MCU reset, so their EHT bits would let in groups
+				// nobody joins again; the filter is kept without HTEN
+				erxfcon = ReadControlRegister(ETH_ERXFCON);
+				if (erxfcon & ETH_ERXFCON_HTEN)
+				{
+					for (byte i = 0; i < 8; ++i) WriteControlRegister(ETH_EHT0 + i, 0);
+					SetRxFilter(erxfcon & ~ETH_ERXFCON_HTEN);
+				}
+
+				// MAC and PHY settings aren't compared : the script of this run
+				// may differ from the previous one and it's a few writes anyway
+				RunScript(*script);
+
+				// #11.3 - frame interrupted on the wire or in its slot
+				BitFieldClear(ETH_ECON1, ETH_ECON1_TXRTS);
+				ResetTx();
+				BitFieldClear(ETH_EIR, ETH_EIR_TXIF | ETH_EIR_TXERIF);
+
+				if (restart == RestartWarmKeepRx)
+				{
+					// #E14 - ERXRDPT is the odd address before the next frame
+					uint16_t rdPtr = ReadControlRegister(ETH_ERXRDPTL) | ((uint16_t)ReadControlRegister(ETH_ERXRDPTH) << 8);
+					nextPktPtr = rdPtr == rxEnd ? ETH_RX_BEGIN : rdPtr + 1;
+				}
+				else
+					ResetRx();
+
+				SetupLinkStatus();
+
+				return true;
+			}
+
+			// registers written bank by bank after a reset ( tbl. #3-2 defaults )
+			void Driver::Configure()
+			{
+				// bank 0
+				SetupMemoryBuffer();
+
+				// bank 1
+				SetupRxFilter();
+
+				// bank 2, PHY
+				RunScript(*script);
+
+				// bank 3
+				SetMacAddress(macAddress);
+#if defined DEBUG && defined DEBUG_ETH_DRIVER
+				DPrint("MAC: ");
+				DPrintHex(ReadControlRegister(ETH_MAADR1)); DPrint('-');
+				DPrintHex(ReadControlRegister(ETH_MAADR2)); DPrint('-');
+				DPrintHex(ReadControlRegister(ETH_MAADR3)); DPrint('-');
+				DPrintHex(ReadControlRegister(ETH_MAADR4)); DPrint('-');
+				DPrintHex(ReadControlRegister(ETH_MAADR5)); DPrint('-');
+				DPrintHex(ReadControlRegister(ETH_MAADR6)); DNewline();
+#endif
+
+				SetupLinkStatus();
+			}
+
+			void Driver::RunScript(const InitScript& _script)
+			{
+				for (byte i = 0; i < _script.regCount; ++i)
+				{
+					auto& w = _script.regs[i];
+					WriteControlRegister(pgm_read_byte(&w.craddress), pgm_read_byte(&w.value));
+				}
+
+				// #3.3.2 - each PHY write waits the previous one; the last one
+				// completes while the next init steps run ( see WaitMii )
+				for (byte i = 0; i < _script.phyRegCount; ++i)
+				{
+					auto& w = _script.phyRegs[i];
+					uint16_t data = pgm_read_word(&w.value);
+
+					WaitMii();
+					WriteControlRegister(ETH_MIREGADR, pgm_read_byte(&w.praddress));
+					WriteControlRegister(ETH_MIWRL, lowByte(data));
+					WriteControlRegister(ETH_MIWRH, highByte(data));
+					miiBusy = true;
+				}
+			}
+
+			InitStateEnum Driver::PollInit()
+			{
+				switch (initState)
+				{
+					case InitReset:
+					{
+						if (initRetries > 0 && millis() - initAt < ETH_INIT_RETRY_MS) break;
+
+						if (initRetries == 0 && restart != RestartCold && WarmRestart())
+						{
+							initState = InitLink;
+							return PollInit();
+						}
+
+						SoftReset();
+						initAt = millis();
+						initState = InitClock;
+					}
+					// fall through
+
+					case InitClock:
+					{
+						// #2.2
+						bool clkRdy = ReadControlRegister(ETH_ESTAT) & ETH_ESTAT_CLKRDY;
+
+						if (!clkRdy && millis() - initAt < ETH_INIT_CLOCK_MS) break;
+
+						auto revId = clkRdy ? RevId() : 0;
+
+#if defined DEBUG && defined DEBUG_ETH_DRIVER
+						DPrint(F("ETH REVID="));
+						DPrint(revId);
+						DNewline();
+						if (revId == 0) { DPrint(F("Reset failed")); DNewline(); }
+#endif
+
+						if (!ValidRevId(revId))
+						{
+							initState = ++initRetries < ETH_INIT_RETRIES ? InitReset : InitFailed;
+							break;
+						}
+
+						Configure();
+						initState = InitLink;
+					}
+					// fall through
+
+					case InitLink:
+					{
+						if (LineStatus() == LineStatusEnum::LinkDown) break;
+
+						EnableRx();
+						initState = InitReady;
+					}
+					break;
+
+					default: break;
+				}
+
+				return initState;
+			}
+
+			InitStateEnum Driver::InitState() const { return initState; }
+
+			void Driver::Reinit()
 			{
-				// #E2
-				delay(1);
+				if (xferDriver == this) WaitTransfer();
+				DisableInterrupt();
+				ResetState();
 
-				//while (ReadControlRegister(ETH_ESTAT) & ETH_ESTAT_CLKRDY);
+				initState = InitReset;
+				initRetries = 0;
 			}
 
 			// #6.5 [fullduplex mode]
@@ -80,20 +257,6 @@ namespace SearchAThing
 			{
 				macAddress = _macAddress;
 
-				// #6.5.1
-				BitFieldSet(ETH_MACON1, ETH_MACON1_TXPAUS | ETH_MACON1_RXPAUS | ETH_MACON1_MARXEN);
-
-				// #6.5.2
-				BitFieldSet(ETH_MACON3, ETH_MACON3_PADCFG0 | ETH_MACON3_TXCRCEN | ETH_MACON3_FRMLNEN | ETH_MACON3_FULDPX);
-				// #6.5.4			
-				WriteControlRegister(ETH_MAMXFL, lowByte(MAX_FRAME_LENGTH));
-				WriteControlRegister(ETH_MAMXFH, highByte(MAX_FRAME_LENGTH));
-				// #6.5.5
-				WriteControlRegister(ETH_MABBIPG, 0x15); // Full-Duplex
-				// #6.5.6
-				WriteControlRegister(ETH_MAIPGL, 0x12);
-				// #6.5.7
-				WriteControlRegister(ETH_MAIPGH, 0x0C);
 				// #6.5.9
 				WriteControlRegister(ETH_MAADR1, macAddress.Buf()[0]);
 				WriteControlRegister(ETH_MAADR2, macAddress.Buf()[1]);
@@ -118,6 +281,7 @@ namespace SearchAThing
 				}
 #endif		
 				while (ReadControlRegister(ETH_EPKTCNT) > 0) BitFieldSet(ETH_ECON2, ETH_ECON2_PKTDEC);
+				pendingPkts = 0;
 
 				// #11.4
 				BitFieldSet(ETH_ECON1, ETH_ECON1_RXRST);
@@ -158,20 +322,40 @@ namespace SearchAThing
 				WriteControlRegister(ETH_ERXRDPTH, highByte(_rdPtr));
 
 				// RX end
-				WriteControlRegister(ETH_ERXNDL, lowByte(ETH_RX_END));
-				WriteControlRegister(ETH_ERXNDH, highByte(ETH_RX_END));
+				WriteControlRegister(ETH_ERXNDL, lowByte(rxEnd));
+				WriteControlRegister(ETH_ERXNDH, highByte(rxEnd));
 			}
 
 			// #3.2.2 - Set TX start/end
 			void Driver::SetupTxMemoryBuffer()
 			{
 				// TX start
-				WriteControlRegister(ETH_ETXSTL, lowByte(ETH_TX_BEGIN));
-				WriteControlRegister(ETH_ETXSTH, highByte(ETH_TX_BEGIN));
+				WritePtrRegister(ETH_ETXSTL, txStartPtr, txBegin);
 
 				// TX end
-				WriteControlRegister(ETH_ETXNDL, lowByte(ETH_TX_END));
-				WriteControlRegister(ETH_ETXNDH, highByte(ETH_TX_END));
+				WritePtrRegister(ETH_ETXNDL, txEndPtr, ETH_TX_END);
+			}
+
+			// #3 - rx ring from ETH_RX_BEGIN, scratch, tx slots up to ETH_TX_END
+			bool Driver::SetLayout(const BufferLayout& layout)
+			{
+				if (layout.txSlots == 0 || layout.txSlots > ETH_TX_SLOTS_MAX) return false;
+
+				// #E14 - FixRdPtr falls back to ERXND that must be odd : being
+				// ETH_TX_END + 1 and ETH_TX_SLOT_SIZE even it's enough an even scratch
+				// ( rounded in 32 bits : 0xFFFF must not wrap to 0 and pass )
+				uint32_t scratch = (uint32_t)layout.scratchSize + layout.scratchSize % 2;
+				uint16_t tx = layout.txSlots * ETH_TX_SLOT_SIZE;
+
+				if ((uint32_t)ETH_RX_BEGIN + ETH_RX_MIN_SIZE + scratch + tx > (uint32_t)ETH_TX_END + 1) return false;
+
+				txSlots = layout.txSlots;
+				txBegin = ETH_TX_END - tx + 1;
+				scratchSize = scratch;
+				scratchBegin = txBegin - scratch;
+				rxEnd = scratchBegin - 1;
+
+				return true;
 			}
 
 			// #3.2 - Set RX start/end/ptr and TX start/end
@@ -181,32 +365,20 @@ namespace SearchAThing
 				SetupTxMemoryBuffer();
 			}
 
-			// #8-3
-			typedef struct PatternMatchFilter
+			// #8
+			void Driver::SetupRxFilter()
 			{
-				byte DstAddr1 : 1; // 0
-				byte DstAddr2 : 1;
-				byte DstAddr3 : 1;
-				byte DstAddr4 : 1;
-				byte DstAddr5 : 1;
-				byte DstAddr6 : 1;
+				// #8.2 - dstmac broadcast and ethertype ARP ( srcmac can be any )
+				PatternFilter arp;
 
-				byte SrcAddr1 : 1;
-				byte SrcAddr2 : 1; // 7
-				byte SrcAddr3 : 1; // 8
-				byte SrcAddr4 : 1;
-				byte SrcAddr5 : 1;
-				byte SrcAddr6 : 1;
+				byte bcast[6];
+				memset(bcast, 0xff, sizeof(bcast));
+				arp.Match(0, bcast, sizeof(bcast));
+				arp.Match16(12, Eth2Type::Eth2Type_ARP);
 
-				byte Type1 : 1;
-				byte Type2 : 1;
-				byte _pad : 2; // 15-14				
-			};
+				SetPatternFilter(arp);
 
-			// #8
-			void Driver::SetupRxFilter()
-			{
-				WriteControlRegister(ETH_ERXFCON,
+				SetRxFilter(
 					// invalid CRC packets will be discarded
 					ETH_ERXFCON_CRCEN |
 
@@ -215,35 +387,127 @@ namespace SearchAThing
 
 					// accepts pattern-match packets
 					ETH_ERXFCON_PMEN);
+			}
+
+			// #8.2
+			void Driver::SetPatternFilter(const PatternFilter& filter)
+			{
+				auto mask = filter.Mask();
+				for (byte i = 0; i < ETH_PATTERN_WINDOW / 8; ++i)
+					WriteControlRegister(ETH_EPMM0 + i, mask[i]);
+
+				auto chksum = filter.Checksum();
+				WriteControlRegister(ETH_EPMCSL, lowByte(chksum));
+				WriteControlRegister(ETH_EPMCSH, highByte(chksum));
+
+				WriteControlRegister(ETH_EPMOL, lowByte(filter.Offset()));
+				WriteControlRegister(ETH_EPMOH, highByte(filter.Offset()));
+			}
 
-				// #8.2
+			// reg. #8-1
+			void Driver::SetRxFilter(byte _erxfcon)
+			{
+				// HTEN kept while groups are joined ( unless accepting all ); in
+				// AND mode it would make the hash match mandatory for every frame
+				if (_erxfcon != 0 && !(_erxfcon & ETH_ERXFCON_ANDOR) && MulticastJoined())
+					_erxfcon |= ETH_ERXFCON_HTEN;
+
+				erxfcon = _erxfcon;
+				WriteControlRegister(ETH_ERXFCON, erxfcon);
+			}
+
+			bool Driver::MulticastJoined() const
+			{
+				for (byte i = 0; i < ETH_MCAST_GROUPS; ++i) if (mcastRefs[i] > 0) return true;
+
+				return false;
+			}
+
+			byte Driver::RxFilter() const { return erxfcon; }
+
+			// #8.4 - bits 28:23 of the CRC-32 of the destination address
+			static byte MulticastHash(const byte *mac)
+			{
+				uint32_t crc = 0xFFFFFFFF;
+
+				for (byte i = 0; i < 6; ++i)
+				{
+					byte b = mac[i];
+					for (byte j = 0; j < 8; ++j)
+					{
+						crc = (crc << 1) ^ ((((crc >> 31) ^ b) & 1) ? 0x04C11DB7 : 0);
+						b >>= 1;
+					}
+				}
+
+				return (crc >> 23) & 0x3F;
+			}
+
+			// rewrites the EHT byte holding the given hash bit from the joined groups
+			void Driver::UpdateHashTable(byte hash)
+			{
+				byte eht = 0;
+
+				for (byte i = 0; i < ETH_MCAST_GROUPS; ++i)
 				{
-					PatternMatchFilter filterPattern;
+					if (mcastRefs[i] == 0) continue;
 
-					byte *b = (byte *)&filterPattern;
-					memset(b, 0, sizeof(PatternMatchFilter));
+					auto h = MulticastHash(mcastMac[i]);
+					if (h / 8 == hash / 8) eht |= (1 << (h % 8));
+				}
 
-					// set the filter to check agains dstmac and ethertype ( srcmac can be any )
+				WriteControlRegister(ETH_EHT0 + hash / 8, eht);
+			}
 
-					filterPattern.DstAddr1 = filterPattern.DstAddr2 = filterPattern.DstAddr3 =
-						filterPattern.DstAddr4 = filterPattern.DstAddr5 = filterPattern.DstAddr6 = 1;
+			bool Driver::JoinMulticast(const byte *mac)
+			{
+				// #8-1 - in AND mode HTEN would drop unicast and broadcast frames
+				if (erxfcon & ETH_ERXFCON_ANDOR) return false;
 
-					filterPattern.Type1 = filterPattern.Type2 = 1;
+				byte free = ETH_MCAST_GROUPS;
 
-					WriteControlRegister(ETH_EPMM0, b[0]);
-					WriteControlRegister(ETH_EPMM1, b[1]);
+				for (byte i = 0; i < ETH_MCAST_GROUPS; ++i)
+				{
+					if (mcastRefs[i] == 0)
+					{
+						if (free == ETH_MCAST_GROUPS) free = i;
+					}
+					else if (memcmp(mcastMac[i], mac, 6) == 0)
+					{
+						++mcastRefs[i];
+						return true;
+					}
 				}
 
+				if (free == ETH_MCAST_GROUPS) return false;
+
+				memcpy(mcastMac[free], mac, 6);
+				mcastRefs[free] = 1;
+
+				UpdateHashTable(MulticastHash(mac));
+
+				// HTEN added unless accepting all ( see SetRxFilter )
+				if (!(erxfcon & ETH_ERXFCON_HTEN)) SetRxFilter(erxfcon);
+
+				return true;
+			}
+
+			bool Driver::LeaveMulticast(const byte *mac)
+			{
+				for (byte i = 0; i < ETH_MCAST_GROUPS; ++i)
 				{
-					byte filterData[6 + 6 + 2];
-					memset(filterData, 0xff, 6); // set srcmac data
-					memset(filterData + 6, 0x00, 6);
-					BufWrite16(filterData + 12, Eth2Type::Eth2Type_ARP); // set ethertype data
+					if (mcastRefs[i] == 0 || memcmp(mcastMac[i], mac, 6) != 0) continue;
+
+					if (--mcastRefs[i] > 0) return true;
 
-					auto chksum = CheckSum(filterData, sizeof(filterData));
-					WriteControlRegister(ETH_EPMCSL, lowByte(chksum));
-					WriteControlRegister(ETH_EPMCSH, highByte(chksum));
+					UpdateHashTable(MulticastHash(mac));
+
+					if (!MulticastJoined()) SetRxFilter(erxfcon & ~ETH_ERXFCON_HTEN);
+
+					return true;
 				}
+
+				return false;
 			}
 
 			// #7.2.1
@@ -259,12 +523,6 @@ namespace SearchAThing
 				BitFieldSet(ETH_ECON1, ETH_ECON1_RXEN);
 			}
 
-			// #6.6
-			void Driver::DisableTxLoopback()
-			{
-				PhyWrite(ETH_PHCON2, ETH_PHCON2_HDLDIS);
-			}
-
 			void Driver::DumpRegs()
 			{
 				DNewline();
@@ -337,28 +595,61 @@ namespace SearchAThing
 
 			}
 
+			// writes the bytes of a L/H pointer register pair that differ from
+			// its shadow ( skipped entirely when the value is already known )
+			void Driver::WritePtrRegister(byte craddressL, uint16_t& shadow, uint16_t ptr)
+			{
+				if (shadow == ptr) return;
+
+				if (shadow == ETH_PTR_UNKNOWN || lowByte(shadow) != lowByte(ptr))
+					WriteControlRegister(craddressL, lowByte(ptr));
+
+				if (shadow == ETH_PTR_UNKNOWN || highByte(shadow) != highByte(ptr))
+					WriteControlRegister(craddressL + 1, highByte(ptr));
+
+				shadow = ptr;
+			}
+
 			// #4.2.2
 			void Driver::SetReadBufferMemoryPtr(uint16_t ptr)
 			{
-				WriteControlRegister(ETH_ERDPTL, lowByte(ptr));
-				WriteControlRegister(ETH_ERDPTH, highByte(ptr));
+				WritePtrRegister(ETH_ERDPTL, readPtr, ptr);
+			}
+
+			// #4.2.2 - ERDPT after len bytes read ( AUTOINC wraps at ERXND )
+			uint16_t Driver::AdvanceReadPtr(uint16_t ptr, uint16_t len)
+			{
+				if (ptr == ETH_PTR_UNKNOWN) return ptr;
+
+				if (ptr <= rxEnd) return WrapRxPtr(ptr, len);
+
+				return (ptr + len) & ETH_BUF_END;
 			}
 
 			// #4.2.4
 			void Driver::SetWriteBufferMemoryPtr(uint16_t ptr)
 			{
-				WriteControlRegister(ETH_EWRPTL, lowByte(ptr));
-				WriteControlRegister(ETH_EWRPTH, highByte(ptr));
+				WritePtrRegister(ETH_EWRPTL, writePtr, ptr);
+			}
+
+			// #4.2.4 - EWRPT after len bytes written ( AUTOINC wraps at 0x1FFF only )
+			uint16_t Driver::AdvanceWritePtr(uint16_t ptr, uint16_t len)
+			{
+				if (ptr == ETH_PTR_UNKNOWN) return ptr;
+
+				return (ptr + len) & ETH_BUF_END;
 			}
 
 			// #4.2.2 - Read single byte from buffer memory at ERDPT
 			byte Driver::ReadBufferMemory()
 			{
 				SPI_BEGIN();
-				SPI.transfer(ETH_SPIOP_RBM);
-				auto data = SPI.transfer(0);
+				spi->Write(ETH_SPIOP_RBM);
+				auto data = spi->Transfer(0);
 				SPI_END();
 
+				readPtr = AdvanceReadPtr(readPtr, 1);
+
 				return data;
 			}
 
@@ -366,40 +657,122 @@ namespace SearchAThing
 			void Driver::ReadBufferMemory(byte *data, uint16_t len)
 			{
 				SPI_BEGIN();
-				SPI.transfer(ETH_SPIOP_RBM);
-				while (len)
-				{
-					*data = SPI.transfer(ETH_SPIOP_RBM);
-					++data;
-					--len;
-				}
+				spi->Write(ETH_SPIOP_RBM);
+				spi->ReadBlock(data, len);
 				SPI_END();
+
+				readPtr = AdvanceReadPtr(readPtr, len);
 			}
 
 			// #4.2.4
 			void Driver::WriteBufferMemory(byte b)
 			{
 				SPI_BEGIN();
-				SPI.transfer(ETH_SPIOP_WBM);
-				SPI.transfer(b);
+				spi->Write(ETH_SPIOP_WBM);
+				spi->Write(b);
 				SPI_END();
+
+				writePtr = AdvanceWritePtr(writePtr, 1);
 			}
 
 			// #4.2.4
 			void Driver::WriteBufferMemory(const byte *data, uint16_t len)
 			{
 				SPI_BEGIN();
-				SPI.transfer(ETH_SPIOP_WBM);
-				while (len)
+				spi->Write(ETH_SPIOP_WBM);
+				spi->WriteBlock(data, len);
+				SPI_END();
+
+				writePtr = AdvanceWritePtr(writePtr, len);
+			}
+
+			// #4.2.2, #4.2.4 - RBM ( tx NULL ) or WBM of len bytes left to the
+			// transport; the transaction is closed by PollTransfer
+			void Driver::StartTransfer(byte *rx, const byte *tx, uint16_t len, SpiDoneCallback done, void *ctx)
+			{
+				SPI_BEGIN();
+
+				xferDriver = this;
+				xferDone = false;
+				xferWrite = tx != NULL;
+				xferHook = done;
+				xferCtx = ctx;
+
+				if (xferWrite)
+				{
+					writePtr = AdvanceWritePtr(writePtr, len);
+
+					spi->Write(ETH_SPIOP_WBM);
+					spi->StartWriteBlock(tx, len, TransferDone, this);
+				}
+				else
+				{
+					readPtr = AdvanceReadPtr(readPtr, len);
+
+					spi->Write(ETH_SPIOP_RBM);
+					spi->StartReadBlock(rx, len, TransferDone, this);
+				}
+
+				// already completed by a blocking transport
+				PollTransfer();
+			}
+
+			Driver *Driver::xferDriver = NULL;
+
+			void Driver::TransferDone(void *ctx, bool ok)
+			{
+				auto drv = (Driver *)ctx;
+
+				drv->xferOk = ok;
+				drv->xferDone = true;
+
+				if (drv->xferHook != NULL) drv->xferHook(drv->xferCtx, ok);
+			}
+
+			// true if no transfer is left open
+			bool Driver::PollTransfer()
+			{
+				if (xferDriver != this) return true;
+
+				if (!xferDone)
 				{
-					SPI.transfer(*data);
-					++data;
-					--len;
+					spi->Poll();
+					if (!xferDone) return false;
 				}
+
 				SPI_END();
+				xferDriver = NULL;
+
+				// position reached by the aborted transfer unknown
+				if (!xferOk)
+				{
+					if (xferWrite)
+						writePtr = ETH_PTR_UNKNOWN;
+					else
+						readPtr = ETH_PTR_UNKNOWN;
+				}
+
+				return true;
+			}
+
+			bool Driver::TransferBusy()
+			{
+				return !PollTransfer();
+			}
+
+			bool Driver::WaitTransfer()
+			{
+				while (!PollTransfer()) delayMicroseconds(ETH_XFER_POLL_US);
+
+				return xferOk;
 			}
 
 			// #3.1.1 - Set bank from Compact Register Address
+			//
+			// current bank is taken from the ECON1 shadow; the switch costs a
+			// single transaction : BFS or BFC when bits only need to be set or
+			// cleared, otherwise a WCR of the whole ECON1 unless TXRTS/DMAST
+			// could have been cleared by the hardware meanwhile
 			void Driver::SetBank(byte craddress)
 			{
 				auto reg = ETH_CRA_REG(craddress);
@@ -407,13 +780,23 @@ namespace SearchAThing
 				if (reg >= ETH_EIE && reg <= ETH_ECON1) return; // all banks register
 
 				byte bank = (craddress >> 5) & B11;
-				if (currentBank != bank || currentBankUnset)
-				{
-					BitFieldClear(ETH_ECON1, ETH_ECON1_BSEL1 | ETH_ECON1_BSEL0);
-					BitFieldSet(ETH_ECON1, bank);
+				byte cur = econ1 & (ETH_ECON1_BSEL1 | ETH_ECON1_BSEL0);
+
+				if (cur == bank) return;
 
-					currentBank = bank;
-					currentBankUnset = false;
+				byte set = bank & ~cur;
+				byte clr = cur & ~bank;
+
+				if (clr == 0)
+					BitFieldSet(ETH_ECON1, set);
+				else if (set == 0)
+					BitFieldClear(ETH_ECON1, clr);
+				else if ((econ1 & (ETH_ECON1_TXRTS | ETH_ECON1_DMAST)) == 0)
+					WriteControlRegister(ETH_ECON1, (econ1 & ~(ETH_ECON1_BSEL1 | ETH_ECON1_BSEL0)) | bank);
+				else
+				{
+					BitFieldClear(ETH_ECON1, clr);
+					BitFieldSet(ETH_ECON1, set);
 				}
 			}
 
@@ -425,13 +808,15 @@ namespace SearchAThing
 				// #4-3
 
 				SPI_BEGIN();
-				SPI.transfer(ETH_SPIOP_RCR | ETH_CRA_REG(craddress));
+				spi->Write(ETH_SPIOP_RCR | ETH_CRA_REG(craddress));
 
-				if (craddress & ETH_MAC_MII_FLAG) SPI.transfer(0); // #4-4		
+				if (craddress & ETH_MAC_MII_FLAG) spi->Write(0); // #4-4		
 
-				auto res = SPI.transfer(0);
+				auto res = spi->Transfer(0);
 				SPI_END();
 
+				if (craddress == ETH_ECON1) econ1 = res;
+
 				return res;
 			}
 
@@ -441,9 +826,11 @@ namespace SearchAThing
 				SetBank(craddress);
 
 				SPI_BEGIN();
-				SPI.transfer(ETH_SPIOP_WCR | ETH_CRA_REG(craddress));
-				SPI.transfer(data);
+				spi->Write(ETH_SPIOP_WCR | ETH_CRA_REG(craddress));
+				spi->Write(data);
 				SPI_END();
+
+				if (craddress == ETH_ECON1) econ1 = data;
 			}
 
 			// #4.2
@@ -452,9 +839,11 @@ namespace SearchAThing
 				SetBank(craddress);
 
 				SPI_BEGIN();
-				SPI.transfer(ETH_SPIOP_BFS | ETH_CRA_REG(craddress));
-				SPI.transfer(data);
+				spi->Write(ETH_SPIOP_BFS | ETH_CRA_REG(craddress));
+				spi->Write(data);
 				SPI_END();
+
+				if (craddress == ETH_ECON1) econ1 |= data;
 			}
 
 			// #4.2
@@ -463,21 +852,47 @@ namespace SearchAThing
 				SetBank(craddress);
 
 				SPI_BEGIN();
-				SPI.transfer(ETH_SPIOP_BFC | ETH_CRA_REG(craddress));
-				SPI.transfer(data);
+				spi->Write(ETH_SPIOP_BFC | ETH_CRA_REG(craddress));
+				spi->Write(data);
 				SPI_END();
+
+				if (craddress == ETH_ECON1) econ1 &= ~data;
 			}
 
 			// #4.2
 			void Driver::SoftReset()
 			{
 				SPI_BEGIN();
-				SPI.transfer(ETH_SPIOP_SRC);
+				spi->Write(ETH_SPIOP_SRC);
 				SPI_END();
 
+				// tbl. #3-2 - ECON1 resets to 0 ( bank 0 ), MII idle
+				econ1 = 0;
+				miiBusy = false;
+
+				ResetState();
+
 				delay(1); // #E2
 			}
 
+			// driver side of a controller reset
+			void Driver::ResetState()
+			{
+				readPtr = ETH_PTR_UNKNOWN;
+				writePtr = ETH_PTR_UNKNOWN;
+				txStartPtr = ETH_PTR_UNKNOWN;
+				txEndPtr = ETH_PTR_UNKNOWN;
+				pendingPkts = 0;
+				rxOpen = false;
+				txOpen = false;
+				txHead = 0;
+				txCount = 0;
+				txState = TxIdle;
+				txSlotFailed = 0;
+				intArmed = false;
+				intEvents = 0;
+			}
+
 			// #E14
 			uint16_t Driver::FixRdPtr(uint16_t ptr)
 			{
@@ -488,39 +903,54 @@ namespace SearchAThing
 					return ptr;
 				}
 #endif
-				if (ptr - 1 > ETH_RX_END)
-					return ETH_RX_END;
-				else
-					return ptr - 1; // odd value
+				// ring start : the odd address before it is the ring end
+				return ptr == ETH_RX_BEGIN ? rxEnd : ptr - 1;
 			}
 
 			// #7-1
 			uint16_t Driver::WrapRxPtr(uint16_t ptr, uint16_t off)
 			{
-				if (ptr + off > ETH_RX_END)
-					return ptr + off - (ETH_RX_END - ETH_RX_BEGIN + 1);
+				if (ptr + off > rxEnd)
+					return ptr + off - (rxEnd - ETH_RX_BEGIN + 1);
 				else
 					return ptr + off;
 			}
 
+			// MISTAT.BUSY for 10.24 us after a script PHY write, bounded in case
+			// the PHY stalls
+			void Driver::WaitMii()
+			{
+				if (!miiBusy) return;
+
+				auto t0 = micros();
+				while ((ReadControlRegister(ETH_MISTAT) & ETH_MISTAT_BUSY) &&
+					micros() - t0 < ETH_MII_TIMEOUT_US)
+					delayMicroseconds(ETH_MII_POLL_US);
+
+				miiBusy = false;
+			}
+
 			// #3.3.1
 			uint16_t Driver::PhyRead(byte praddress)
 			{
+				WaitMii();
+
 				// #3.3.1.1
 				WriteControlRegister(ETH_MIREGADR, praddress);
 
-				// #3.3.1.2
-				BitFieldSet(ETH_MICMD, ETH_MICMD_MIIRD);
+				// #3.3.1.2 ( #4.2.5 - no BFS on MAC/MII registers )
+				WriteControlRegister(ETH_MICMD, ETH_MICMD_MIIRD);
 
 				// #3.3.1.3
 
+				delayMicroseconds(11); // 10.24 us
 				while (ReadControlRegister(ETH_MISTAT) & ETH_MISTAT_BUSY)
 				{
 					delayMicroseconds(11); // 10.24 us
 				}
 
 				// #3.3.1.4
-				BitFieldClear(ETH_MICMD, ETH_MICMD_MIIRD);
+				WriteControlRegister(ETH_MICMD, 0);
 
 				auto high = ReadControlRegister(ETH_MIRDH);
 				auto low = ReadControlRegister(ETH_MIRDL);
@@ -531,6 +961,8 @@ namespace SearchAThing
 			// #3.3.2
 			void Driver::PhyWrite(byte praddress, uint16_t data)
 			{
+				WaitMii();
+
 				// #3.3.2.1
 				WriteControlRegister(ETH_MIREGADR, praddress);
 
@@ -564,12 +996,19 @@ namespace SearchAThing
 #endif
 			}
 
-			void Driver::UpdateLineStatus()
+			// #12.1.5 - link changes reported through EIR.LINKIF, PHSTAT2 read
+			// only when it's set
+			void Driver::SetupLinkStatus()
 			{
-				//lineStatus = LineStatusEnum::LinkUp;
+				PhyWrite(ETH_PHIE, ETH_PHIE_PGEIE | ETH_PHIE_PLNKIE);
+				PhyRead(ETH_PHIR);
 
 				ReadLinkStatus();
+				linkPolledAt = millis();
+			}
 
+			void Driver::UpdateLineStatus()
+			{
 				auto eir = ReadControlRegister(ETH_EIR);
 
 				if (eir & ETH_EIR_DMAIF)
@@ -581,12 +1020,19 @@ namespace SearchAThing
 					BitFieldClear(ETH_EIR, ETH_EIR_DMAIF);
 				}
 
-				if (eir & ETH_EIR_LINKIF)
+				if (eir & ETH_EIR_RXERIF)
 				{
-					ReadLinkStatus();
+					// #12.1.2
+					++stats.rxOverflows;
+					BitFieldClear(ETH_EIR, ETH_EIR_RXERIF);
+				}
 
+				if (eir & ETH_EIR_LINKIF)
+				{
 					// #12.1.5
 					PhyRead(ETH_PHIR);
+
+					ReadLinkStatus();
 				}
 			}
 
@@ -651,92 +1097,305 @@ namespace SearchAThing
 				DNewline();
 			}
 
-			//----------------------------------------------------------
-
-			Driver::Driver()
+#if defined DEBUG && defined DEBUG_ETH_BENCH
+			// prints bytes/us as fixed point with 2 decimals
+			static void PrintRate(uint32_t len, uint32_t us)
 			{
+				auto r = us > 0 ? len * 100UL / us : 0;
+				DPrint(r / 100); DPrint('.');
+				if (r % 100 < 10) DPrint('0');
+				DPrint(r % 100);
+				DPrint(F(" B/us"));
 			}
 
-			Driver::Driver(const RamData& _macAddress)
+			// #4.2.2, #4.2.4 - buffer memory throughput for a full size frame
+			// streamed into the tx region and read back, using the per-byte
+			// spi->Transfer() loop ( loop ) and the block engine ( block )
+			void Driver::BenchBufferMemory()
 			{
-#if defined DEBUG && defined DEBUG_ASSERT
-				if (ETH_RX_END % 2 == 0)
-				{
-					DPrint(F("* FixRdPtr() expects an odd ETH_RX_END")); DNewline();
-				}
-#endif								
+				byte chunk[64];
+				for (byte i = 0; i < sizeof(chunk); ++i) chunk[i] = i;
 
-				while (true)
+				for (byte block = 0; block < 2; ++block)
 				{
-					InitSPI();
+					SetWriteBufferMemoryPtr(txBegin);
+
+					auto t = micros();
+					SPI_BEGIN();
+					spi->Write(ETH_SPIOP_WBM);
+					for (uint16_t off = 0; off < MAX_FRAME_LENGTH; off += sizeof(chunk))
+					{
+						uint16_t n = MAX_FRAME_LENGTH - off;
+						if (n > sizeof(chunk)) n = sizeof(chunk);
 
-					SoftReset();
+						if (block)
+							spi->WriteBlock(chunk, n);
+						else
+							for (uint16_t i = 0; i < n; ++i) spi->Transfer(chunk[i]);
+					}
+					SPI_END();
+					auto wus = micros() - t;
 
-					// #2.2
-					WaitAfterPoweron();
+					SetReadBufferMemoryPtr(txBegin);
 
-					auto revId = RevId();
+					t = micros();
+					SPI_BEGIN();
+					spi->Write(ETH_SPIOP_RBM);
+					for (uint16_t off = 0; off < MAX_FRAME_LENGTH; off += sizeof(chunk))
+					{
+						uint16_t n = MAX_FRAME_LENGTH - off;
+						if (n > sizeof(chunk)) n = sizeof(chunk);
 
-#if defined DEBUG && defined DEBUG_ETH_DRIVER
-					DPrint(F("ETH REVID="));
-					DPrint(revId);
+						if (block)
+							spi->ReadBlock(chunk, n);
+						else
+							for (uint16_t i = 0; i < n; ++i) chunk[i] = spi->Transfer(0);
+					}
+					SPI_END();
+					auto rus = micros() - t;
+
+					readPtr = ETH_PTR_UNKNOWN;
+					writePtr = ETH_PTR_UNKNOWN;
+
+					DPrint(block ? F("block") : F("loop "));
+					DPrint(F(" wbm ")); PrintRate(MAX_FRAME_LENGTH, wus);
+					DPrint(F(" rbm ")); PrintRate(MAX_FRAME_LENGTH, rus);
 					DNewline();
-					if (revId == 0) { DPrint(F("Reset failed")); DNewline(); }
+				}
+			}
 #endif
 
-					if (revId == B10 || // B1
-						revId == B100 || // B4
-						revId == B101 || // B5 
-						revId == B110) // B7
-						break;
+			//----------------------------------------------------------
 
-					delay(1000);
-				}
+			Driver::Driver()
+			{
+			}
 
-				SetupMemoryBuffer();
+			Driver::Driver(const RamData& _macAddress, const BufferLayout& layout, RestartEnum _restart,
+				const InitScript& _script, byte _csPin, uint32_t _spiClock) :
+				defaultSpi(_csPin, _spiClock)
+			{
+				Setup(_macAddress, layout, _restart, _script);
+			}
 
-				SetMacAddress(_macAddress);
+			Driver::Driver(SpiTransport& _spi, const RamData& _macAddress, const BufferLayout& layout,
+				RestartEnum _restart, const InitScript& _script)
+			{
+				spi = &_spi;
+
+				Setup(_macAddress, layout, _restart, _script);
+			}
+
+			void Driver::Setup(const RamData& _macAddress, const BufferLayout& layout, RestartEnum _restart,
+				const InitScript& _script)
+			{
+				restart = _restart;
+				script = &_script;
+
+				if (!SetLayout(layout))
+				{
 #if defined DEBUG && defined DEBUG_ETH_DRIVER
-				DPrint("MAC: ");
-				DPrintHex(ReadControlRegister(ETH_MAADR1)); DPrint('-');
-				DPrintHex(ReadControlRegister(ETH_MAADR2)); DPrint('-');
-				DPrintHex(ReadControlRegister(ETH_MAADR3)); DPrint('-');
-				DPrintHex(ReadControlRegister(ETH_MAADR4)); DPrint('-');
-				DPrintHex(ReadControlRegister(ETH_MAADR5)); DPrint('-');
-				DPrintHex(ReadControlRegister(ETH_MAADR6)); DNewline();
+					DPrint(F("* invalid buffer layout, using default")); DNewline();
 #endif
+					SetLayout(BufferLayoutDefault);
+				}
 
-				SetupRxFilter();
+				macAddress = _macAddress;
 
-				DisableTxLoopback();
+				spi->Begin();
 
-				EnableRx();
+				auto start = millis();
 
-				while (LineStatus() == LineStatusEnum::LinkDown);
+				while (PollInit() != InitReady && initState != InitFailed &&
+					millis() - start < ETH_INIT_TIMEOUT_MS)
+					delay(1);
 			}
 
 			Driver::~Driver()
 			{
+				if (xferDriver == this) WaitTransfer();
+				DisableInterrupt();
 			}
 
 			const RamData& Driver::MacAddress() const { return macAddress; }
 
-			// determine the line status
 			LineStatusEnum Driver::LineStatus()
 			{
-				UpdateLineStatus();
+				if (initState < InitLink) return lineStatus;
+
+				if (intEnabled && intArmed)
+				{
+					// LINKIF asserts the INT pin
+					if (intPending) ServiceInterrupt();
+				}
+				else if (millis() - linkPolledAt >= ETH_LINK_POLL_MS)
+				{
+					linkPolledAt = millis();
+					UpdateLineStatus();
+				}
 
 				return lineStatus;
 			}
 
+			const DriverStats& Driver::Stats() const { return stats; }
+
+			void Driver::ResetStats()
+			{
+				memset(&stats, 0, sizeof(stats));
+			}
+
+			// #E6 - true if a frame is waiting in the rx ring; EPKTCNT is read
+			// again only when the frames it reported last time have been consumed
+			// and, in interrupt mode, only if the INT pin isn't armed ( being
+			// PKTIF unreliable the ring is known to be empty only reading EPKTCNT )
+			bool Driver::RxPending()
+			{
+				if (pendingPkts == 0)
+				{
+					if (intEnabled)
+					{
+						if (intPending) ServiceInterrupt();
+
+						if (intArmed) return false;
+					}
+
+					pendingPkts = ReadControlRegister(ETH_EPKTCNT);
+
+					if (pendingPkts == 0)
+					{
+						// #12 - INT asserts again if something arrived meanwhile
+						if (intEnabled)
+						{
+							BitFieldSet(ETH_EIE, ETH_EIE_INTIE);
+							intArmed = true;
+						}
+
+						return false;
+					}
+
+					// #12.1.2 - frames dropped on a full ring : flagged while
+					// frames were pending, so sampled along with them ( the isr
+					// samples it in interrupt mode )
+					if (!intEnabled && (ReadControlRegister(ETH_EIR) & ETH_EIR_RXERIF))
+					{
+						++stats.rxOverflows;
+						BitFieldClear(ETH_EIR, ETH_EIR_RXERIF);
+					}
+				}
+
+				if (nextPktPtr > rxEnd)
+				{
+#if defined DEBUG && defined DEBUG_ETH_RX
+					DPrint(F("* Invalid nextPtr=")); DPrintHex(nextPktPtr); DNewline();
+#endif
+					++stats.rxResets;
+					ResetRx();
+					return false;
+				}
+
+				return true;
+			}
+
+			// #7-3 - frame length from rxStatusVector, 0 if flags are invalid
+			uint16_t Driver::RxStatusLength()
+			{
+				if (rxStatusVector.crcError) ++stats.rxCrcErrors;
+				if (rxStatusVector.lengthCheckError) ++stats.rxLengthErrors;
+
+				if (!rxStatusVector.receivedOk || rxStatusVector.crcError || rxStatusVector.lengthCheckError)
+					return 0;
+
+				return rxStatusVector.receivedByteCount;
+			}
+
+			// #7.2.2 - Next Packet Pointer and Receive Status Vector of the frame
+			// at nextPktPtr are read with a single burst; when buf is given and
+			// the frame fits capacity the data follows in the same transaction.
+			// Returns the frame length ( 0 if flags are invalid ).
+			uint16_t Driver::OpenRx(byte *buf, uint16_t capacity)
+			{
+				rxPktPtr = nextPktPtr;
+
+				// #4.2.2 ( no-op when the previous frame was read up to its end )
+				SetReadBufferMemoryPtr(rxPktPtr);
+
+				byte hdr[2 + sizeof(RxStatusVector)];
+				uint16_t rd = sizeof(hdr);
+
+				SPI_BEGIN();
+				spi->Write(ETH_SPIOP_RBM);
+				spi->ReadBlock(hdr, sizeof(hdr));
+
+				nextPktPtr = (uint16_t)hdr[0] | ((uint16_t)hdr[1] << 8);
+				memcpy(&rxStatusVector, hdr + 2, sizeof(rxStatusVector));
+
+				auto len = RxStatusLength();
+
+				if (buf != NULL && len > 0 && len <= capacity)
+				{
+					// Read data
+					spi->ReadBlock(buf, len);
+					rd += len;
+
+					// consume the pad byte so that ERDPT lands on the next frame
+					if (len % 2 != 0)
+					{
+						spi->ReadBlock(hdr, 1);
+						++rd;
+					}
+				}
+				SPI_END();
+
+				readPtr = AdvanceReadPtr(rxPktPtr, rd);
+
+				rxLen = len;
+				rxOpen = true;
+
+#if defined DEBUG && defined DEBUG_ETH_RX_VERBOSE
+				DPrint(F(" nextPtr:")); DPrintHex(nextPktPtr); DPrint(' ');
+				PrintRxStatusVector();
+#endif
+
+				return len;
+			}
+
+			// #7.2.4 + #E14 - frees the ring space up to nextPktPtr ( the given
+			// number of frames ); EPKTCNT has no bulk decrement, one PKTDEC each
+			void Driver::ReleaseRx(byte frames)
+			{
+				auto _nextPktPtr = FixRdPtr(nextPktPtr);
+
+				WriteControlRegister(ETH_ERXRDPTL, lowByte(_nextPktPtr));
+				WriteControlRegister(ETH_ERXRDPTH, highByte(_nextPktPtr));
+
+				for (byte i = 0; i < frames; ++i) BitFieldSet(ETH_ECON2, ETH_ECON2_PKTDEC);
+				pendingPkts -= frames;
+			}
+
+			// frees the opened frame space
+			void Driver::CloseRx()
+			{
+				ReleaseRx(1);
+
+				rxOpen = false;
+			}
+
 			uint16_t Driver::Receive(byte *buf, uint16_t capacity)
 			{
+				if (initState != InitReady && PollInit() != InitReady) return 0;
+
 				lastPktCapacity = capacity;
 
-				// #E6
-				auto pktCnt = ReadControlRegister(ETH_EPKTCNT);
+#if defined DEBUG && defined DEBUG_ETH_SPI
+				auto spiStart = stats.spiTransactions;
+#endif
 
-				if (pktCnt == 0) return 0;
+				if (rxOpen) CloseRx();
+
+				// keep the tx queue moving
+				if (txCount > 0) AdvanceTransmit();
+
+				if (!RxPending()) return 0;
 
 				/*
 				if (LineStatus() == LineStatusEnum::LinkDown)
@@ -757,88 +1416,226 @@ namespace SearchAThing
 #endif
 
 #if defined DEBUG && defined DEBUG_ETH_RX
-				DPrint(F("RXSTAT pktCnt:")); DPrint(pktCnt);
+				DPrint(F("RXSTAT pktCnt:")); DPrint(pendingPkts);
 #if !defined DEBUG_ETH_RX_VERBOSE
 				DNewline();
 #endif
 #endif
 
-				if (nextPktPtr > ETH_RX_END)
+				auto len = OpenRx(buf, capacity);
+
+				if (len > 0)
 				{
+					if (len <= capacity)
+					{
+#if defined DEBUG && defined DEBUG_ETH_RX_VERBOSE
+						DPrintHex(buf, len, true); DNewline();
+#endif
+
+#if defined DEBUG && defined DEBUG_ETH2
+						Eth2Print(Eth2GetHeader(buf));
+#endif
+						++stats.rxFrames;
+						stats.rxBytes += len;
+					}
+					else
+					{
+						++stats.rxDropped;
 #if defined DEBUG && defined DEBUG_ETH_RX
-					DPrint(F("* Invalid nextPtr=")); DPrintHex(nextPktPtr); DNewline();
+						DPrint(F("* rx size invalid "));
+
+						DPrint(len); DPrint('>'); DPrint(capacity); DNewline();
+#endif
+						len = 0;
+					}
+				}
+				else
+				{
+#if defined DEBUG && defined DEBUG_ETH_RX
+					DPrint(F("* rx flags invalid")); DNewline();
 #endif
-					ResetRx();
-					return 0;
 				}
 
-				// #4.2.2
-				SetReadBufferMemoryPtr(nextPktPtr);
+				CloseRx();
 
-				// #7.2.2
+#if defined DEBUG && defined DEBUG_ETH_SPI
+				lastRxTransactions = stats.spiTransactions - spiStart;
+#endif
 
-				// Next Packet Pointer
-				nextPktPtr = (uint16_t)ReadBufferMemory() | ((uint16_t)ReadBufferMemory() << 8);
+#if defined DEBUG && defined DEBUG_ETH_RX && defined DEBUG_ETH_SPI
+				DPrint(F("rx spi transactions:")); DPrint(lastRxTransactions); DNewline();
+#endif
 
-				// Receive Status Vector
-				ReadBufferMemory((byte *)&rxStatusVector, sizeof(rxStatusVector));
+				return len;
+			}
 
-#if defined DEBUG && defined DEBUG_ETH_RX_VERBOSE
-				DPrint(F(" nextPtr:")); DPrintHex(nextPktPtr); DPrint(' ');
-				PrintRxStatusVector();
-#endif
+			byte Driver::ReceiveBatch(RxFrame *frames, byte count)
+			{
+				if (initState != InitReady && PollInit() != InitReady) return 0;
+
+				if (rxOpen) CloseRx();
+
+				// keep the tx queue moving
+				if (txCount > 0) AdvanceTransmit();
 
-				auto len = rxStatusVector.receivedByteCount;
+				if (count == 0 || !RxPending()) return 0;
 
-				if (rxStatusVector.receivedOk && !rxStatusVector.crcError && !rxStatusVector.lengthCheckError)
+				if (count > pendingPkts) count = pendingPkts;
+
+				byte n = 0;
+				bool rbm = false;
+
+				while (n < count)
 				{
-					if (len > 0 && len <= capacity)
+					auto& frame = frames[n];
+					auto pktPtr = nextPktPtr;
+
+					// frames are contiguous in the ring : the previous read left
+					// ERDPT on this header ( AUTOINC wraps at ERXND )
+					if (!rbm)
 					{
-						// Read data							
-						ReadBufferMemory(buf, len);
+						SetReadBufferMemoryPtr(pktPtr);
+						SPI_BEGIN();
+						spi->Write(ETH_SPIOP_RBM);
+						rbm = true;
+					}
 
-#if defined DEBUG && defined DEBUG_ETH_RX_VERBOSE
-						DPrintHex(buf, len, true); DNewline();
-#endif
+					// #7.2.2
+					byte hdr[2 + sizeof(RxStatusVector)];
+					uint16_t rd = sizeof(hdr);
+					spi->ReadBlock(hdr, sizeof(hdr));
 
-#if defined DEBUG && defined DEBUG_ETH2
-						Eth2Print(Eth2GetHeader(buf));
+					nextPktPtr = (uint16_t)hdr[0] | ((uint16_t)hdr[1] << 8);
+					memcpy(&rxStatusVector, hdr + 2, sizeof(rxStatusVector));
+
+					if (nextPktPtr > rxEnd)
+					{
+						SPI_END();
+						readPtr = ETH_PTR_UNKNOWN;
+#if defined DEBUG && defined DEBUG_ETH_RX
+						DPrint(F("* Invalid nextPtr=")); DPrintHex(nextPktPtr); DNewline();
 #endif
+						++stats.rxResets;
+						ResetRx();
+						return n;
+					}
+
+					auto len = RxStatusLength();
+
+					if (len > 0 && len <= frame.capacity)
+					{
+						spi->ReadBlock(frame.buf, len);
+						rd += len;
+
+						if (len % 2 != 0)
+						{
+							spi->ReadBlock(hdr, 1);
+							++rd;
+						}
+
+						frame.len = len;
+						++stats.rxFrames;
+						stats.rxBytes += len;
 					}
 					else
 					{
+						if (len > 0) ++stats.rxDropped;
 #if defined DEBUG && defined DEBUG_ETH_RX
-						DPrint(F("* rx size invalid "));
-
-						DPrint(len); DPrint('>'); DPrint(capacity); DNewline();
+						DPrint(F("* rx frame dropped len=")); DPrint(len); DNewline();
 #endif
-						len = 0;
+						frame.len = 0;
+					}
+
+					readPtr = AdvanceReadPtr(pktPtr, rd);
+
+					// skip the data of a dropped frame or resync on a gap
+					if (readPtr != nextPktPtr)
+					{
+						SPI_END();
+						rbm = false;
 					}
+
+					++n;
 				}
-				else
+
+				if (rbm) SPI_END();
+
+				ReleaseRx(n);
+
+				return n;
+			}
+
+			uint16_t Driver::BeginReceive()
+			{
+				if (initState != InitReady && PollInit() != InitReady) return 0;
+
+				if (rxOpen) CloseRx();
+
+				if (!RxPending()) return 0;
+
+				auto len = OpenRx(NULL, 0);
+
+				if (len == 0)
 				{
 #if defined DEBUG && defined DEBUG_ETH_RX
 					DPrint(F("* rx flags invalid")); DNewline();
 #endif
-					len = 0;
+					CloseRx();
+				}
+				else
+				{
+					++stats.rxFrames;
+					stats.rxBytes += len;
 				}
 
-				auto _nextPktPtr = FixRdPtr(nextPktPtr);
+				return len;
+			}
 
-				// #7.2.4 + #E14									
-				WriteControlRegister(ETH_ERXRDPTL, lowByte(_nextPktPtr));
-				WriteControlRegister(ETH_ERXRDPTH, highByte(_nextPktPtr));
+			uint16_t Driver::ReadReceived(uint16_t off, byte *buf, uint16_t len)
+			{
+				if (!rxOpen || off >= rxLen) return 0;
 
-				BitFieldSet(ETH_ECON2, ETH_ECON2_PKTDEC);
+				if (len > rxLen - off) len = rxLen - off;
+
+				// #7-1 frame data follows the 6 bytes header, ring wrap handled
+				// by WrapRxPtr here and by the ERDPT AUTOINC wrap during the read
+				SetReadBufferMemoryPtr(WrapRxPtr(rxPktPtr, 6 + off));
+				ReadBufferMemory(buf, len);
 
 				return len;
-			}			
+			}
 
-			// transmit the packet ( before to fill the packet with the tx data call RxHandled if an rx packet was managed or FlushRx otherwise )			
-			bool Driver::Transmit(const byte *buf, uint16_t len)
+			uint16_t Driver::StartReadReceived(uint16_t off, byte *buf, uint16_t len, SpiDoneCallback done, void *ctx)
 			{
-				lastPktCapacity = len;
+				if (!rxOpen || off >= rxLen) return 0;
+
+				if (len > rxLen - off) len = rxLen - off;
+
+				SetReadBufferMemoryPtr(WrapRxPtr(rxPktPtr, 6 + off));
+				StartTransfer(buf, NULL, len, done, ctx);
+
+				return len;
+			}
+
+			byte Driver::ReadReceived(uint16_t off)
+			{
+				byte b = 0;
+				ReadReceived(off, &b, 1);
+
+				return b;
+			}
+
+			void Driver::EndReceive()
+			{
+				if (rxOpen) CloseRx();
+			}
 
+#if defined DEBUG && defined DEBUG_ETH_SPI
+			uint16_t Driver::LastRxTransactions() const { return lastRxTransactions; }
+#endif
+
+			bool Driver::BeginTransmit()
+			{
 				/*
 				if (LineStatus() == LineStatusEnum::LinkDown)
 				{
@@ -848,132 +1645,641 @@ namespace SearchAThing
 					return;
 				}*/
 
+				if (initState < InitLink && PollInit() < InitLink) return false;
 
 #if defined DEBUG && defined DEBUG_ETH_TX
 				DPrint(F("--> TX")); DNewline();
-#endif								
+#endif
 
-#if defined DEBUG && defined DEBUG_ETH_TX
-				if (len == 0)
+				// all slots queued : wait the one on the wire
+				while (txCount == txSlots)
 				{
-					DPrint(F("* tx len zero")); DNewline();
-					return false;
+					if (AdvanceTransmit() == TxPending && txCount == txSlots)
+						delayMicroseconds(ETH_TX_POLL_US);
 				}
-				if (len > (ETH_TX_END - ETH_TX_BEGIN))
+
+				txSlotPtr = TxSlotPtr((txHead + txCount) % txSlots);
+
+				// #7.1.2
+				SetWriteBufferMemoryPtr(txSlotPtr);
+				// control byte ( POVERRIDE=0 -> use of MACON3 )
+				WriteBufferMemory(0);
+
+				txLen = 0;
+				txOpen = true;
+
+				return true;
+			}
+
+			uint16_t Driver::WriteTransmit(const byte *buf, uint16_t len)
+			{
+				if (!txOpen) return 0;
+
+				if (len > ETH_TX_CAPACITY - txLen)
 				{
+#if defined DEBUG && defined DEBUG_ETH_TX
 					DPrint(F("* tx len excessive")); DNewline();
-					return false;
+#endif
+					len = ETH_TX_CAPACITY - txLen;
 				}
+
+				if (len == 0) return 0;
+
+				// no-op unless a PatchTransmit moved EWRPT back
+				SetWriteBufferMemoryPtr(txSlotPtr + 1 + txLen);
+				WriteBufferMemory(buf, len);
+
+				txLen += len;
+
+				return len;
+			}
+
+			uint16_t Driver::StartWriteTransmit(const byte *buf, uint16_t len, SpiDoneCallback done, void *ctx)
+			{
+				if (!txOpen) return 0;
+
+				if (len > ETH_TX_CAPACITY - txLen)
+				{
+#if defined DEBUG && defined DEBUG_ETH_TX
+					DPrint(F("* tx len excessive")); DNewline();
 #endif
+					len = ETH_TX_CAPACITY - txLen;
+				}
+
+				if (len == 0) return 0;
 
-				if (ReadControlRegister(ETH_EIR) & ETH_EIR_TXERIF)
+				SetWriteBufferMemoryPtr(txSlotPtr + 1 + txLen);
+				StartTransfer(NULL, buf, len, done, ctx);
+
+				txLen += len;
+
+				return len;
+			}
+
+			uint16_t Driver::WriteTransmit(const TxSegment *segs, byte count)
+			{
+				if (!txOpen) return 0;
+
+				// in 32 bits : large segments must not wrap into a small total
+				uint32_t total = 0;
+				for (byte i = 0; i < count; ++i) total += segs[i].len;
+
+				if (total > (uint32_t)(ETH_TX_CAPACITY - txLen))
 				{
 #if defined DEBUG && defined DEBUG_ETH_TX
-					DPrint(F("* tx ERR")); DNewline();
+					DPrint(F("* tx len excessive")); DNewline();
 #endif
-					// #E12
-					BitFieldSet(ETH_ECON1, ETH_ECON1_TXRTS);
-					BitFieldClear(ETH_ECON1, ETH_ECON1_TXRTS);
-					BitFieldClear(ETH_EIR, ETH_EIR_TXERIF);
+					return 0;
+				}
 
-					delay(20);
+				if (total == 0) return 0;
+
+				SetWriteBufferMemoryPtr(txSlotPtr + 1 + txLen);
+
+				// #4.2.4 - all segments within a single WBM
+				SPI_BEGIN();
+				spi->Write(ETH_SPIOP_WBM);
+				for (byte i = 0; i < count; ++i)
+				{
+					if (segs[i].progmem)
+						spi->WriteBlock_P(segs[i].buf, segs[i].len);
+					else
+						spi->WriteBlock(segs[i].buf, segs[i].len);
 				}
+				SPI_END();
 
-				uint16_t txFrom = ETH_TX_BEGIN;
-				uint16_t txTo = ETH_TX_BEGIN + len + 1;
+				writePtr = AdvanceWritePtr(writePtr, total);
+				txLen += total;
 
-				// #7.1.1
-				WriteControlRegister(ETH_ETXSTL, lowByte(txFrom));
-				WriteControlRegister(ETH_ETXSTH, highByte(txFrom));
+				return total;
+			}
 
-				// #7.1.2
-				SetWriteBufferMemoryPtr(txFrom);
-				// control byte ( POVERRIDE=0 -> use of MACON3 )				
-				WriteBufferMemory(0);
+			bool Driver::PatchTransmit(uint16_t off, const byte *buf, uint16_t len)
+			{
+				if (!txOpen || off > txLen || len > txLen - off) return false;
+
+				SetWriteBufferMemoryPtr(txSlotPtr + 1 + off);
 				WriteBufferMemory(buf, len);
 
+				return true;
+			}
+
+			uint16_t Driver::TxSlotPtr(byte slot) const
+			{
+				return txBegin + slot * ETH_TX_SLOT_SIZE;
+			}
+
+			// #7.1.4, #7.1.5
+			void Driver::KickTransmit()
+			{
+				BitFieldClear(ETH_EIR, ETH_EIR_TXIF);
+				BitFieldSet(ETH_ECON1, ETH_ECON1_TXRTS);
+			}
+
+			// put on the wire the frame queued in the given slot
+			void Driver::StartSlot(byte slot)
+			{
+				// control byte at txFrom, frame data up to txTo included
+				uint16_t txFrom = TxSlotPtr(slot);
+				uint16_t txTo = txFrom + txSlotLen[slot];
+
+				// #7.1.1
+				WritePtrRegister(ETH_ETXSTL, txStartPtr, txFrom);
+
 				// #7.1.3
-				WriteControlRegister(ETH_ETXNDL, lowByte(txTo));
-				WriteControlRegister(ETH_ETXNDH, highByte(txTo));
+				WritePtrRegister(ETH_ETXNDL, txEndPtr, txTo);
 
-#if defined DEBUG && defined DEBUG_ETH_TX_VERBOSE									 
-				DPrint(F("tx req len=")); DPrint(len);
+#if defined DEBUG && defined DEBUG_ETH_TX_VERBOSE
+				DPrint(F("tx req len=")); DPrint(txSlotLen[slot]);
 				DPrint(F(" [")); DPrintHex(txFrom);
 				DPrint('-'); DPrintHex(txTo);
 				DPrint(']'); DNewline();
-#endif														
+#endif
 
-				// #7.1.4
-				BitFieldClear(ETH_EIR, ETH_EIR_TXIF);
+				KickTransmit();
 
-				// #7.1.5
-				BitFieldSet(ETH_ECON1, ETH_ECON1_TXRTS);
+				txRetries = 0;
+				txRetryWait = false;
+			}
+
+			bool Driver::StartTransmit()
+			{
+				if (!txOpen) return false;
+
+				txOpen = false;
+
+				auto len = txLen;
+				lastPktCapacity = len;
+
+				if (len == 0)
+				{
+#if defined DEBUG && defined DEBUG_ETH_TX
+					DPrint(F("* tx len zero")); DNewline();
+#endif
+					return false;
+				}
+
+				auto slot = (txHead + txCount) % txSlots;
+				txSlotLen[slot] = len;
+				txSlotFailed &= ~(1 << slot);
+
+				if (txCount++ == 0)
+				{
+					// a failure not reported yet is kept
+					if (txState != TxFailed) txState = TxPending;
+					StartSlot(slot);
+				}
+
+				return true;
+			}
+
+			bool Driver::StartTransmit(const byte *buf, uint16_t len)
+			{
+				if (len == 0 || len > ETH_TX_CAPACITY)
+				{
+#if defined DEBUG && defined DEBUG_ETH_TX
+					DPrint(F("* tx len invalid")); DNewline();
+#endif
+					return false;
+				}
+
+				if (!BeginTransmit()) return false;
+				WriteTransmit(buf, len);
+
+				return StartTransmit();
+			}
+
+			TxStateEnum Driver::PollTransmit()
+			{
+				auto res = AdvanceTransmit();
+
+				// outcome reported once
+				if (res != TxPending) txState = TxIdle;
 
-				// wait transmission finish
-				while (ReadControlRegister(ETH_ECON1) & ETH_ECON1_TXRTS);
+				return res;
+			}
+
+			TxStateEnum Driver::AdvanceTransmit()
+			{
+				if (txCount == 0) return txState;
+
+				if (intEnabled && !txRetryWait)
+				{
+					if (intPending) ServiceInterrupt();
+
+					// armed INT : TXIF, TXERIF not raised yet
+					if (intArmed && !(intEvents & (ETH_EIR_TXIF | ETH_EIR_TXERIF))) return TxPending;
+				}
+
+				if (txRetryWait)
+				{
+					if ((long)(millis() - txRetryAt) < 0) return TxPending;
+
+					// frame still in its slot between ETXST and ETXND
+					txRetryWait = false;
+					KickTransmit();
+
+					return TxPending;
+				}
+
+				// #7.1 - TXRTS cleared by the hardware at the end of transmission
+				if (ReadControlRegister(ETH_ECON1) & ETH_ECON1_TXRTS) return TxPending;
+
+				// #7.1 - tx status vector written after ETXND
+				SetReadBufferMemoryPtr(txEndPtr + 1);
+				ReadBufferMemory((byte *)&txStatusVector, sizeof(txStatusVector));
 
 #if defined DEBUG && defined DEBUG_ETH_TX_VERBOSE
-				DPrintHex(buf, len, true); DNewline();
+				DPrint("TXSTAT "); PrintTxStatusVector();
 #endif
 
-				bool err = false;
+				bool failed = false;
 
-				if (ReadControlRegister(ETH_EIR) & ETH_EIR_TXIF)
+				bool txErr = (ReadControlRegister(ETH_EIR) | intEvents) & ETH_EIR_TXERIF;
+				intEvents &= ~(ETH_EIR_TXIF | ETH_EIR_TXERIF);
+
+				stats.txCollisions += txStatusVector.txCollCount;
+				if (txStatusVector.txLateColl) ++stats.txLateCollisions;
+
+				if (!txStatusVector.txDone || txErr)
 				{
-					auto estat = ReadControlRegister(ETH_ESTAT);
-					if (estat & ETH_ESTAT_TXABRT)
-					{
+					++stats.txAborts;
+
 #if defined DEBUG && defined DEBUG_ETH_TX
-						DPrint(F("* TxAbort")); DNewline();
-#endif			
-						err = true;
+					{
+						auto estat = ReadControlRegister(ETH_ESTAT);
+						if (estat & ETH_ESTAT_TXABRT) { DPrint(F("* TxAbort")); DNewline(); }
+						if (estat & ETH_ESTAT_LATECOL) { DPrint(F("* LateCol")); DNewline(); }
 					}
-					if (estat & ETH_ESTAT_LATECOL)
+#endif
+
+					// #12.1.3, #E12 - reset the transmit logic
+					BitFieldSet(ETH_ECON1, ETH_ECON1_TXRST);
+					BitFieldClear(ETH_ECON1, ETH_ECON1_TXRST);
+					BitFieldClear(ETH_EIR, ETH_EIR_TXERIF);
+
+					if (txRetries < ETH_TX_RETRIES)
 					{
 #if defined DEBUG && defined DEBUG_ETH_TX
-						DPrint(F("* LateCol")); DNewline();
-#endif				
-						err = true;
+						DPrint(F("* tx retry ")); DPrint(txRetries + 1); DNewline();
+#endif
+						++txRetries;
+						txRetryAt = millis() + ETH_TX_RETRY_MS;
+						txRetryWait = true;
+
+						return TxPending;
 					}
+
+					failed = true;
+				}
+
+				if (failed)
+				{
+					txState = TxFailed;
+					txSlotFailed |= 1 << txHead;
 				}
 				else
 				{
-					// #12.1.4
-					BitFieldClear(ETH_EIR, ETH_EIR_TXIF);
+					++stats.txFrames;
+					stats.txBytes += txStatusVector.txdByteCount;
 				}
 
-				if (!err)
+				// slot released, start the next queued one
+				txHead = (txHead + 1) % txSlots;
+				--txCount;
+
+				if (txCount > 0)
 				{
+					StartSlot(txHead);
+					return TxPending;
+				}
 
-#if defined DEBUG && defined DEBUG_ETH_TX_VERBOSE
-					DPrint(F("waiting tx end")); DNewline();
+				if (txState == TxPending) txState = TxDone;
+
+				return txState;
+			}
+
+			byte Driver::TxSlotsFree() const
+			{
+				return txSlots - txCount - (txOpen ? 1 : 0);
+			}
+
+			// last byte address of a DMA range ( #13 - wraps in the rx ring )
+			uint16_t Driver::DmaEnd(uint16_t start, uint16_t len)
+			{
+				if (start <= rxEnd) return WrapRxPtr(start, len - 1);
+
+				return start + len - 1;
+			}
+
+			void Driver::WaitDma()
+			{
+				while (DmaBusy()) delayMicroseconds(ETH_DMA_POLL_US);
+			}
+
+			// #13 - EDMAST, EDMAND for len bytes from start
+			bool Driver::SetDmaRange(uint16_t start, uint16_t len)
+			{
+				if (len == 0 || start > ETH_BUF_END) return false;
+
+				auto end = DmaEnd(start, len);
+				if (end > ETH_BUF_END) return false;
+
+				WriteControlRegister(ETH_EDMASTL, lowByte(start));
+				WriteControlRegister(ETH_EDMASTH, highByte(start));
+				WriteControlRegister(ETH_EDMANDL, lowByte(end));
+				WriteControlRegister(ETH_EDMANDH, highByte(end));
+
+				return true;
+			}
+
+			// #13.2
+			bool Driver::StartDmaChecksum(uint16_t start, uint16_t len)
+			{
+				if (!SetDmaRange(start, len)) return false;
+
+				BitFieldSet(ETH_ECON1, ETH_ECON1_CSUMEN | ETH_ECON1_DMAST);
+
+				return true;
+			}
+
+			// #13.1
+			uint16_t Driver::CopyReceived(uint16_t off, uint16_t len, uint16_t dstOff)
+			{
+				if (!rxOpen || !txOpen || off >= rxLen || dstOff > txLen) return 0;
+
+				if (len > rxLen - off) len = rxLen - off;
+				if (len > ETH_TX_CAPACITY - dstOff) len = ETH_TX_CAPACITY - dstOff;
+
+				// #7-1 frame data follows the 6 bytes header
+				if (!SetDmaRange(WrapRxPtr(rxPktPtr, 6 + off), len)) return 0;
+
+				uint16_t dst = txSlotPtr + 1 + dstOff;
+				WriteControlRegister(ETH_EDMADSTL, lowByte(dst));
+				WriteControlRegister(ETH_EDMADSTH, highByte(dst));
+
+				if (econ1 & ETH_ECON1_CSUMEN) BitFieldClear(ETH_ECON1, ETH_ECON1_CSUMEN);
+				BitFieldSet(ETH_ECON1, ETH_ECON1_DMAST);
+
+				WaitDma();
+
+				if (dstOff + len > txLen) txLen = dstOff + len;
+
+				return len;
+			}
+
+			bool Driver::DmaBusy()
+			{
+				return ReadControlRegister(ETH_ECON1) & ETH_ECON1_DMAST;
+			}
+
+			uint16_t Driver::DmaChecksum()
+			{
+				return ((uint16_t)ReadControlRegister(ETH_EDMACSH) << 8) | ReadControlRegister(ETH_EDMACSL);
+			}
+
+			// checksum of len bytes at start through the DMA, or read over SPI
+			// if ETH_SOFT_CHECKSUM ( #E15 ); ERDPT AUTOINC wraps in the rx
+			// ring as the DMA does
+			uint16_t Driver::Checksum(uint16_t start, uint16_t len)
+			{
+#if ETH_SOFT_CHECKSUM
+				byte chunk[32];
+				uint32_t sum = 0;
+
+				SetReadBufferMemoryPtr(start);
+
+				SPI_BEGIN();
+				spi->Write(ETH_SPIOP_RBM);
+				for (uint16_t done = 0; done < len;)
+				{
+					uint16_t n = len - done < sizeof(chunk) ? len - done : sizeof(chunk);
+					spi->ReadBlock(chunk, n);
+
+					// even sized chunks : words never straddle them
+					for (uint16_t k = 0; k < n; ++k)
+						sum += (k & 1) ? chunk[k] : (uint16_t)chunk[k] << 8;
+
+					done += n;
+				}
+				SPI_END();
+
+				readPtr = AdvanceReadPtr(readPtr, len);
+
+				while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+
+				return ~sum;
+#else
+				StartDmaChecksum(start, len);
+				WaitDma();
+
+				return DmaChecksum();
 #endif
-					do
-					{
-						// read tx status vector
-						SetReadBufferMemoryPtr(txTo + 1);
-						ReadBufferMemory((byte *)&txStatusVector, sizeof(txStatusVector));
-					} while (!txStatusVector.txDone);
+			}
 
-#if defined DEBUG && defined DEBUG_ETH_TX_VERBOSE
-					if (txStatusVector.txDone)
-					{
-						DPrint(F("TX done len=")); DNewline();
-					}
-					DPrint("TXSTAT "); PrintTxStatusVector();
-#endif				
+			// adds partial to the sum the checksum was computed from
+			static uint16_t ChecksumAdd(uint16_t chksum, uint16_t partial)
+			{
+				if (partial == 0) return chksum;
+
+				uint32_t sum = (uint16_t)~chksum + (uint32_t)partial;
+				while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+
+				return ~sum;
+			}
+
+			uint16_t Driver::TxChecksum(uint16_t off, uint16_t len, uint16_t partial)
+			{
+				if (!txOpen || off > txLen || len > txLen - off || len == 0) return 0;
+
+				return ChecksumAdd(Checksum(txSlotPtr + 1 + off, len), partial);
+			}
+
+			bool Driver::PatchTxChecksum(uint16_t off, uint16_t len, uint16_t csumOff, uint16_t partial)
+			{
+				if (!txOpen || off > txLen || len > txLen - off || len == 0) return false;
+
+				auto chksum = TxChecksum(off, len, partial);
+
+				byte b[2] = { highByte(chksum), lowByte(chksum) };
+
+				return PatchTransmit(csumOff, b, 2);
+			}
+
+			uint16_t Driver::RxChecksum(uint16_t off, uint16_t len, uint16_t partial)
+			{
+				if (!rxOpen || off > rxLen || len > rxLen - off || len == 0) return 0;
+
+				// #7-1 frame data follows the 6 bytes header
+				return ChecksumAdd(Checksum(WrapRxPtr(rxPktPtr, 6 + off), len), partial);
+			}
+
+			Driver *Driver::intDrivers[ETH_INT_INSTANCES];
+
+			void Driver::Isr0() { if (intDrivers[0] != NULL) intDrivers[0]->intPending = true; }
+			void Driver::Isr1() { if (intDrivers[1] != NULL) intDrivers[1]->intPending = true; }
+
+			bool Driver::EnableInterrupt(byte intPin)
+			{
+				if (intEnabled) DisableInterrupt();
+
+				// without an isr the armed rx would never be polled again
+				int num = digitalPinToInterrupt(intPin);
+				if (num == NOT_AN_INTERRUPT) return false;
+
+				byte i = 0;
+				while (i < ETH_INT_INSTANCES && intDrivers[i] != NULL) ++i;
+
+				if (i == ETH_INT_INSTANCES) return false;
+
+				intDrivers[i] = this;
+				intNum = num;
+				intPending = false;
+				intArmed = false;
+				intEvents = 0;
+
+				pinMode(intPin, INPUT);
+
+				// #12 - INTIE left clear until the rx ring is found empty
+				WriteControlRegister(ETH_EIE,
+					ETH_EIE_PKTIE | ETH_EIE_LINKIE | ETH_EIE_TXIE | ETH_EIE_TXERIE | ETH_EIE_RXERIE);
+
+				attachInterrupt(intNum, i == 0 ? Isr0 : Isr1, FALLING);
+
+				intEnabled = true;
+
+				return true;
+			}
+
+			void Driver::DisableInterrupt()
+			{
+				if (!intEnabled) return;
+
+				detachInterrupt(intNum);
+
+				WriteControlRegister(ETH_EIE, 0);
+
+				for (byte i = 0; i < ETH_INT_INSTANCES; ++i)
+					if (intDrivers[i] == this) intDrivers[i] = NULL;
+
+				intEnabled = false;
+				intArmed = false;
+			}
+
+			bool Driver::InterruptPending() const { return intPending; }
+
+			// #12 - INT released, tx flags recorded into intEvents and cleared;
+			// PKTIF clears by itself when EPKTCNT reaches 0 ( see RxPending )
+			void Driver::ServiceInterrupt()
+			{
+				intPending = false;
+
+				BitFieldClear(ETH_EIE, ETH_EIE_INTIE);
+				intArmed = false;
+
+				auto eir = ReadControlRegister(ETH_EIR);
+
+				intEvents |= eir & (ETH_EIR_TXIF | ETH_EIR_TXERIF);
+
+				if (eir & ETH_EIR_RXERIF) ++stats.rxOverflows;
+
+				// #12.1.2, #12.1.3, #12.1.4 ( TXERIF left to PollTransmit through intEvents )
+				byte clr = eir & (ETH_EIR_TXIF | ETH_EIR_TXERIF | ETH_EIR_RXERIF);
+				if (clr) BitFieldClear(ETH_EIR, clr);
+
+				// #12.1.5
+				if (eir & ETH_EIR_LINKIF)
+				{
+					PhyRead(ETH_PHIR);
+					ReadLinkStatus();
 				}
+			}
+
+			uint16_t Driver::RxBufferSize() const { return rxEnd - ETH_RX_BEGIN + 1; }
+			byte Driver::TxSlots() const { return txSlots; }
+			uint16_t Driver::ScratchBegin() const { return scratchBegin; }
+			uint16_t Driver::ScratchSize() const { return scratchSize; }
+
+			bool Driver::ReadScratch(uint16_t off, byte *buf, uint16_t len)
+			{
+				if (off > scratchSize || len > scratchSize - off) return false;
+
+				SetReadBufferMemoryPtr(scratchBegin + off);
+				ReadBufferMemory(buf, len);
+
+				return true;
+			}
+
+			bool Driver::WriteScratch(uint16_t off, const byte *buf, uint16_t len)
+			{
+				if (off > scratchSize || len > scratchSize - off) return false;
+
+				SetWriteBufferMemoryPtr(scratchBegin + off);
+				WriteBufferMemory(buf, len);
+
+				return true;
+			}
+
+			TxStateEnum Driver::WaitTransmit()
+			{
+				TxStateEnum res;
+
+				while ((res = PollTransmit()) == TxPending) delayMicroseconds(ETH_TX_POLL_US);
+
+				return res;
+			}
+
+			// outcome of this frame only : the queue report is left to
+			// PollTransmit for the frames started asynchronously
+			bool Driver::EndTransmit()
+			{
+				auto slot = (txHead + txCount) % txSlots;
+
+				if (!StartTransmit()) return false;
+
+				while (AdvanceTransmit() == TxPending) delayMicroseconds(ETH_TX_POLL_US);
 
 #if defined DEBUG && defined DEBUG_ETH_TX && defined DEBUG_ETH_REGS
 				DumpRegs();
-#endif				
+#endif
+
+				return !(txSlotFailed & (1 << slot));
+			}
 
-				if (err) 
+			// transmit the packet ( before to fill the packet with the tx data call RxHandled if an rx packet was managed or FlushRx otherwise )			
+			bool Driver::Transmit(const byte *buf, uint16_t len)
+			{
+				if (len == 0 || len > ETH_TX_CAPACITY)
+				{
+#if defined DEBUG && defined DEBUG_ETH_TX
+					DPrint(F("* tx len invalid")); DNewline();
+#endif
 					return false;
-				else
-					return true;
+				}
+
+				if (!BeginTransmit()) return false;
+				WriteTransmit(buf, len);
+
+#if defined DEBUG && defined DEBUG_ETH_TX_VERBOSE
+				DPrintHex(buf, len, true); DNewline();
+#endif
+
+				return EndTransmit();
 			}
-			
+
+			bool Driver::Transmit(const TxSegment *segs, byte count)
+			{
+				if (!BeginTransmit()) return false;
+
+				if (WriteTransmit(segs, count) == 0)
+				{
+					txOpen = false;
+					return false;
+				}
+
+				return EndTransmit();
+			}
+
 		}
 
 	}
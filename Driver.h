@@ -35,56 +35,126 @@
 #include "WProgram.h"
 #endif
 
-#include <SearchAThing.Arduino.Utils\DebugMacros.h>
+#include <SearchAThing.Arduino.Utils/DebugMacros.h>
 
-#include <SearchAThing.Arduino.Utils\Util.h>
-#include <SearchAThing.Arduino.Utils\SList.h>
-#include <SearchAThing.Arduino.Utils\RamData.h>
-#include <SearchAThing.Arduino.Utils\IdStorage.h>
+#include <SearchAThing.Arduino.Utils/Util.h>
+#include <SearchAThing.Arduino.Utils/SList.h>
+#include <SearchAThing.Arduino.Utils/RamData.h>
+#include <SearchAThing.Arduino.Utils/IdStorage.h>
 using namespace SearchAThing::Arduino;
 
-#include <SearchAThing.Arduino.Net\Protocol.h>
-#include <SearchAThing.Arduino.Net\ARP.h>
-#include <SearchAThing.Arduino.Net\ICMP.h>
-#include <SearchAThing.Arduino.Net\DNS.h>
-#include <SearchAThing.Arduino.Net\DHCP.h>
-#include <SearchAThing.Arduino.Net\EthDriver.h>
-#include <SearchAThing.Arduino.Net\EthProcess.h>
+#include <SearchAThing.Arduino.Net/Protocol.h>
+#include <SearchAThing.Arduino.Net/ARP.h>
+#include <SearchAThing.Arduino.Net/ICMP.h>
+#include <SearchAThing.Arduino.Net/DNS.h>
+#include <SearchAThing.Arduino.Net/DHCP.h>
+#include <SearchAThing.Arduino.Net/EthDriver.h>
+#include <SearchAThing.Arduino.Net/EthProcess.h>
 using namespace SearchAThing::Arduino::Net;
 
 #include "Registers.h"
 #include "RxStatusVector.h"
 #include "TxStatusVector.h"
+#include "DriverStats.h"
+#include "PatternFilter.h"
+#include "InitScript.h"
+#include "SpiTransport.h"
 
 #if USE_DHCP>0
-#include <SearchAThing.Arduino.Net\DHCP.h>
+#include <SearchAThing.Arduino.Net/DHCP.h>
 #endif
 
 //----------------------------------------------------------------------
 
-// #4.1
-#define DPIN_CS				10
+// #12 - INT output ( active low ), to an external interrupt capable pin
+#define DPIN_INT			2
+
+// multicast groups that can be joined at the same time
+#ifndef ETH_MCAST_GROUPS
+#define ETH_MCAST_GROUPS	4
+#endif
+
+// drivers that can use the interrupt mode at the same time
+#define ETH_INT_INSTANCES	2
 
 // #3 - Ethernet Buffer (0x0000 -> 0x1FFF) = 8K
 #define ETH_BUF_START	0x0000
 #define ETH_BUF_END		0x1FFF
 
-// maximize rx buffer cause mcu need to build each transmitted packets while
-// the enc28j60 can receive more packets without blocking the mcu
-// #E5
+// buffer partition ( see BufferLayout ) : rx ring from ETH_RX_BEGIN ( #E5 ),
+// optional scratch region, tx slots up to ETH_TX_END
+
+// max frames that can be queued for transmission ( up to 8 : a bit per
+// slot in Driver::txSlotFailed )
+#ifndef ETH_TX_SLOTS_MAX
+#define ETH_TX_SLOTS_MAX	4
+#endif
+static_assert(ETH_TX_SLOTS_MAX <= 8, "ETH_TX_SLOTS_MAX must be at most 8");
+
+// frame bytes that fit a tx slot ( FCS appended by the MAC, MACON3.TXCRCEN )
+#define ETH_TX_CAPACITY	(MAX_FRAME_LENGTH - 4)
+
+// #7.1 - per packet control byte + frame + 7 bytes tx status vector
+#define ETH_TX_SLOT_SIZE	(1 + ETH_TX_CAPACITY + 7)
 
 // TX(end)		: 0x1FFF = 8191
 #define ETH_TX_END		ETH_BUF_END
 
-// TX(begin)	: 0x1A12 = 6674
-#define ETH_TX_BEGIN	(ETH_TX_END - MAX_FRAME_LENGTH + 1)
+// deferred retries of a frame aborted by the MAC ( #12.1.3 )
+#ifndef ETH_TX_RETRIES
+#define ETH_TX_RETRIES	2
+#endif
+#define ETH_TX_RETRY_MS	20
+
+// ECON1.TXRTS poll period of blocking transmit
+#define ETH_TX_POLL_US	10
+
+// ECON1.DMAST poll period of blocking DMA operations
+#define ETH_DMA_POLL_US	5
+
+// #3.3.2 - MISTAT.BUSY poll period and max wait of the init script PHY writes
+#define ETH_MII_POLL_US	2
+#define ETH_MII_TIMEOUT_US	100
+
+// #E15 - a DMA checksum while ECON1.RXEN is set can make the receiver lose
+// incoming frames : TxChecksum/RxChecksum read the range over SPI ( 1 ), or
+// define 0 to use the DMA, a few SPI bytes whatever the length but with
+// that rx loss ( StartDmaChecksum always uses the DMA )
+#ifndef ETH_SOFT_CHECKSUM
+#define ETH_SOFT_CHECKSUM	1
+#endif
+
+// completion poll period of WaitTransfer ( asynchronous SPI transfers )
+#define ETH_XFER_POLL_US	2
+
+// #2.2 - max wait of ESTAT.CLKRDY after a reset
+#define ETH_INIT_CLOCK_MS	10
 
-// RX(end)		: 0x1A11 = 6673
-#define ETH_RX_END		(ETH_TX_BEGIN - 1)
+// resets issued before giving up on an invalid EREVID
+#ifndef ETH_INIT_RETRIES
+#define ETH_INIT_RETRIES	3
+#endif
+#define ETH_INIT_RETRY_MS	1000
+
+// max time the constructor spends bringing up the controller ( see PollInit )
+#ifndef ETH_INIT_TIMEOUT_MS
+#define ETH_INIT_TIMEOUT_MS	100
+#endif
+
+// min period between EIR.LINKIF checks of LineStatus ( polling mode )
+#ifndef ETH_LINK_POLL_MS
+#define ETH_LINK_POLL_MS	10
+#endif
 
 // RX(start)	: 0x0000
 #define ETH_RX_BEGIN	ETH_BUF_START
 
+// smallest rx ring : a full size frame with its 6 bytes header and pad
+#define ETH_RX_MIN_SIZE	(6 + MAX_FRAME_LENGTH + 1)
+
+// buffer pointer shadow not known ( valid pointers are <= ETH_BUF_END )
+#define ETH_PTR_UNKNOWN	0xFFFF
+
 // Errata Silicon Revs
 #define ETH_REV_B1	B0010
 #define ETH_REV_B4	B0100
@@ -100,42 +170,216 @@ namespace SearchAThing
 		namespace Enc28j60
 		{
 
+			// frame piece for the scatter-gather transmit ( buf in flash
+			// when progmem is set )
+			struct TxSegment
+			{
+				const byte *buf;
+				uint16_t len;
+				bool progmem;
+			};
+
+			// caller buffer for the batched receive ( len set to the received
+			// frame length, 0 if the frame was dropped )
+			struct RxFrame
+			{
+				byte *buf;
+				uint16_t capacity;
+				uint16_t len;
+			};
+
+			// #E14 - ERXND stays odd only if the tx slots keep an even size
+			// ( see Driver::SetLayout )
+			static_assert(ETH_TX_SLOT_SIZE % 2 == 0, "ETH_TX_SLOT_SIZE must be even");
+
+			// #3 - buffer memory partition chosen at construction
+			struct BufferLayout
+			{
+				// frames queued for transmission ( 1..ETH_TX_SLOTS_MAX )
+				byte txSlots;
+				// bytes reserved between the rx ring and the tx slots
+				// ( rounded up to even so that ERXND stays odd, #E14 )
+				uint16_t scratchSize;
+			};
+
+			// rx 5148 bytes, 2 tx slots
+			const BufferLayout BufferLayoutDefault = { 2, 0 };
+			// rx 6670 bytes, 1 tx slot ( receive-heavy gateways )
+			const BufferLayout BufferLayoutRxLarge = { 1, 0 };
+			// rx 2104 bytes, 4 tx slots ( send-heavy nodes )
+			const BufferLayout BufferLayoutTxHeavy = { 4, 0 };
+			// rx 5646 bytes, 1 tx slot, 1K scratch
+			const BufferLayout BufferLayoutScratch = { 1, 1024 };
+
+			// controller bring up ( see Driver::PollInit )
+			enum InitStateEnum
+			{
+				InitFailed,		// invalid EREVID after ETH_INIT_RETRIES resets
+				InitReset,		// reset to be issued
+				InitClock,		// #2.2 - waiting the oscillator
+				InitLink,		// configured, rx enabled when the link is up
+				InitReady
+			};
+
+			// controller found already configured at startup ( MCU only reset )
+			enum RestartEnum
+			{
+				RestartCold,			// reset it anyway
+				RestartWarm,			// reuse it, rx ring flushed
+				RestartWarmKeepRx		// reuse it with the frames already received
+			};
+
+			// state of the last started transmission
+			enum TxStateEnum
+			{
+				TxIdle,
+				TxPending,
+				TxDone,
+				TxFailed
+			};
+
 			class Driver : public EthDriver
 			{
 
 			private:
-				byte currentBank = ETH_BANK0;
-				bool currentBankUnset = true;
+				// shadow of ECON1 ( bank select included ); TXRTS and DMAST may
+				// have been cleared by the hardware since last access
+				byte econ1 = 0;
+
+				// bus access, defaultSpi unless given to the constructor
+				// ( single instruction CS toggles when csPin is DPIN_CS )
+				CsPinSpiTransport<DPIN_CS> defaultSpi;
+				SpiTransport *spi = &defaultSpi;
+
+				InitStateEnum initState = InitReset;
+				RestartEnum restart = RestartWarm;
+				const InitScript *script = &InitScriptDefault;
+				byte initRetries = 0;
+				unsigned long initAt = 0;
 
 				LineStatusEnum lineStatus = LineStatusEnum::LinkDown;
+				unsigned long linkPolledAt = 0;
 
 				RxStatusVector rxStatusVector;
 				TxStatusVector txStatusVector;
 
-				uint16_t nextPktPtr;
+				uint16_t nextPktPtr = ETH_RX_BEGIN;
+
+				// ERXFCON
+				byte erxfcon = 0;
+
+				// joined multicast groups ( refs 0 = free entry )
+				byte mcastMac[ETH_MCAST_GROUPS][6];
+				byte mcastRefs[ETH_MCAST_GROUPS] = { 0 };
+
+				// buffer partition ( see SetLayout ), BufferLayoutDefault until set
+				uint16_t rxEnd = ETH_TX_END - BufferLayoutDefault.txSlots * ETH_TX_SLOT_SIZE;
+				uint16_t scratchBegin = ETH_TX_END + 1 - BufferLayoutDefault.txSlots * ETH_TX_SLOT_SIZE;
+				uint16_t scratchSize = 0;
+				uint16_t txBegin = ETH_TX_END + 1 - BufferLayoutDefault.txSlots * ETH_TX_SLOT_SIZE;
+				byte txSlots = BufferLayoutDefault.txSlots;
+
+				// shadows of ERDPT, EWRPT, ETXST, ETXND ( ETH_PTR_UNKNOWN if not known )
+				uint16_t readPtr = ETH_PTR_UNKNOWN;
+				uint16_t writePtr = ETH_PTR_UNKNOWN;
+				uint16_t txStartPtr = ETH_PTR_UNKNOWN;
+				uint16_t txEndPtr = ETH_PTR_UNKNOWN;
+
+				// frames reported by the last EPKTCNT read not yet consumed
+				byte pendingPkts = 0;
+
+				// frame opened in the rx ring ( header position and length )
+				bool rxOpen = false;
+				uint16_t rxPktPtr;
+				uint16_t rxLen;
+
+				// frame being written in the tx slot at txSlotPtr ( length )
+				bool txOpen = false;
+				uint16_t txSlotPtr;
+				uint16_t txLen;
+
+				// #3.3.2 - PHY write of the init script left running ( MISTAT.BUSY
+				// polled before the next MII access only )
+				bool miiBusy = false;
+
+				// tx slots queue : txCount frames starting from slot txHead
+				// ( the one on the wire ); txState is the outcome of the frames
+				// sent since PollTransmit last reported it, txSlotFailed the
+				// outcome of the last frame of each slot ( bit per slot )
+				byte txHead = 0;
+				byte txCount = 0;
+				uint16_t txSlotLen[ETH_TX_SLOTS_MAX];
+				TxStateEnum txState = TxIdle;
+				byte txSlotFailed = 0;
+				byte txRetries;
+				bool txRetryWait;
+				unsigned long txRetryAt;
+
+				// interrupt mode : the isr only sets intPending; EIE.INTIE is
+				// set ( intArmed ) when the rx ring is found empty and cleared
+				// while servicing, so that nothing can be pending while armed
+				bool intEnabled = false;
+				bool intArmed = false;
+				volatile bool intPending = false;
+				byte intNum;
+				// EIR.TXIF/TXERIF seen while servicing, consumed by PollTransmit
+				byte intEvents = 0;
+
+				// asynchronous RBM/WBM block : the transaction stays open
+				// ( xferDriver == this ) until the transport reports it
+				// ( xferDone ) and PollTransfer closes it; pointer shadows and
+				// txLen already account for it. The owner is one for all the
+				// drivers so that none selects its controller while the bus is
+				// held ( drivers on separate buses are serialized too )
+				static Driver *xferDriver;
+				volatile bool xferDone = false;
+				volatile bool xferOk = true;
+				bool xferWrite;
+				SpiDoneCallback xferHook;
+				void *xferCtx;
+
+				static void TransferDone(void *ctx, bool ok);
+
+				static Driver *intDrivers[ETH_INT_INSTANCES];
+				static void Isr0();
+				static void Isr1();
+
+				DriverStats stats = {};
+
+#if defined DEBUG && defined DEBUG_ETH_SPI
+				uint16_t lastRxTransactions = 0;
+#endif
 
 				RamData macAddress;
 				uint16_t lastPktCapacity;
 
-				void InitSPI();
-				void WaitAfterPoweron();
+				void Setup(const RamData& _macAddress, const BufferLayout& layout, RestartEnum _restart,
+					const InitScript& _script);
+				void Configure();
+				void RunScript(const InitScript& script);
+				bool WarmRestart();
 				void SetMacAddress(const RamData& _macAddress);
 				void ResetRx();
 				void ResetTx();
 				void SetupRxMemoryBuffer();
 				void SetupTxMemoryBuffer();
+				bool SetLayout(const BufferLayout& layout);
 				void SetupMemoryBuffer();
 				void SetupRxFilter();
+				void UpdateHashTable(byte hash);
+				bool MulticastJoined() const;
 				void DisableRx();
 				void EnableRx();
-				void DisableTxLoopback();
 				void DumpRegs();
 
 				// Set read pointer to given ptr
 				void SetReadBufferMemoryPtr(uint16_t ptr);
+				uint16_t AdvanceReadPtr(uint16_t ptr, uint16_t len);
 				byte ReadBufferMemory();
 				void ReadBufferMemory(byte *data, uint16_t len);
 				void SetWriteBufferMemoryPtr(uint16_t ptr);
+				uint16_t AdvanceWritePtr(uint16_t ptr, uint16_t len);
+				void WritePtrRegister(byte craddressL, uint16_t& shadow, uint16_t ptr);
 				void WriteBufferMemory(byte b);
 				void WriteBufferMemory(const byte *data, uint16_t len);
 				void SetBank(byte craddress);
@@ -144,19 +388,42 @@ namespace SearchAThing
 				void BitFieldSet(byte craddress, byte data);
 				void BitFieldClear(byte craddress, byte data);
 				void SoftReset();
+				void ResetState();
 				uint16_t FixRdPtr(uint16_t ptr);
 				uint16_t WrapRxPtr(uint16_t ptr, uint16_t off);
 
+				void WaitMii();
 				uint16_t PhyRead(byte praddress);
 				void PhyWrite(byte praddress, uint16_t data);
 
+				void ServiceInterrupt();
+
+				uint16_t DmaEnd(uint16_t start, uint16_t len);
+				bool SetDmaRange(uint16_t start, uint16_t len);
+				void WaitDma();
+				uint16_t Checksum(uint16_t start, uint16_t len);
+
+				void StartTransfer(byte *rx, const byte *tx, uint16_t len, SpiDoneCallback done, void *ctx);
+				bool PollTransfer();
+
+				bool RxPending();
+				uint16_t RxStatusLength();
+				uint16_t OpenRx(byte *buf, uint16_t capacity);
+				void ReleaseRx(byte frames);
+				void CloseRx();
+
+				uint16_t TxSlotPtr(byte slot) const;
+				void KickTransmit();
+				void StartSlot(byte slot);
+				TxStateEnum AdvanceTransmit();
+
+				void SetupLinkStatus();
 				void ReadLinkStatus();
 				void UpdateLineStatus();
 
 				//--
 
 				byte RevId();
-				const RxStatusVector& GetRxStatusVector() const;
 				void PrintRxStatusVector() const;
 
 				const TxStatusVector& GetTxStatusVector() const;
@@ -165,19 +432,336 @@ namespace SearchAThing
 
 			public:
 				Driver();
-				Driver(const RamData& _macAddress);
+				Driver(const RamData& _macAddress, const BufferLayout& layout = BufferLayoutDefault,
+					RestartEnum _restart = RestartWarm, const InitScript& _script = InitScriptDefault,
+					byte _csPin = DPIN_CS, uint32_t _spiClock = ETH_SPI_CLOCK);
+				// controller reached through the given transport
+				Driver(SpiTransport& _spi, const RamData& _macAddress, const BufferLayout& layout = BufferLayoutDefault,
+					RestartEnum _restart = RestartWarm, const InitScript& _script = InitScriptDefault);
 
 				// Destructor
 				~Driver();
 
+				// Initialization
+				// ~~~~~~~~~~~~~~
+				// the constructor spends at most ETH_INIT_TIMEOUT_MS bringing up
+				// the controller, even without link; Receive and Transmit advance
+				// the remaining steps so that rx starts as soon as the link is up.
+				// A controller still running with the same MAC and layout ( MCU
+				// only reset ) is resumed without reset unless RestartCold.
+				// MAC and PHY settings come from the given InitScript ( see
+				// InitScriptHalfDuplex ). The controller is selected through
+				// csPin ( DPIN_CS by default ) at spiClock, or reached through a
+				// custom SpiTransport.
+				//
+				// Controllers sharing the bus get a driver each with its own
+				// csPin; every SPI transaction is bounded by a single call, so a
+				// bridge alternating them stays fair as long as it doesn't block
+				// on a busy port :
+				//
+				//   RxFrame f = { buf, sizeof(buf), 0 };
+				//   if (b->TxSlotsFree() > 0 && a->ReceiveBatch(&f, 1) && f.len > 0)
+				//     b->StartTransmit(buf, f.len - 4); // FCS excluded
+				//   ... same from b to a
+				//
+				// EthNet starts DHCP right away, so create it once the link is up,
+				// one init step per loop() :
+				//
+				//   if (net == NULL)
+				//   {
+				//     if (drv->PollInit() != InitReady)
+				//     {
+				//       if (drv->InitState() == InitFailed) drv->Reinit(); // not responding
+				//       return;
+				//     }
+				//     net = new EthNet(drv);
+				//   }
+
+				// run the next init step without blocking ( a reset takes 1 ms,
+				// #E2 ); returns the reached state
+				InitStateEnum PollInit();
+				InitStateEnum InitState() const;
+
+				// start the bring up over ( after InitFailed or a controller power
+				// loss ) as at construction; queued frames are dropped and the
+				// interrupt mode is left ( see EnableInterrupt )
+				void Reinit();
+
 				const RamData& MacAddress() const;
 
-				// determine the line status
+				// cached line status, refreshed on PHY link change interrupt
+				// ( EIR.LINKIF checked at most every ETH_LINK_POLL_MS or
+				// through the INT pin in interrupt mode )
 				LineStatusEnum LineStatus();
 
+				// counters since construction or ResetStats(); rxOverflows is
+				// updated when EIR is read ( LineStatus, interrupt mode, receive
+				// finding new frames )
+				const DriverStats& Stats() const;
+				void ResetStats();
+
 				uint16_t Receive(byte *buf, uint16_t capacity);
+
+				// drain up to count frames already in the rx ring into the given
+				// buffers reading them with a single RBM and freeing their space
+				// at once; returns the number of frames consumed
+				byte ReceiveBatch(RxFrame *frames, byte count);
+
+				// Zero-copy receive
+				// ~~~~~~~~~~~~~~~~~
+				// the frame stays in the enc28j60 rx ring and only requested
+				// ranges are moved over SPI
+				//
+				//   auto len = drv->BeginReceive();
+				//   if (len > 0)
+				//   {
+				//     drv->ReadReceived(0, hdr, sizeof(hdr));
+				//     ...
+				//     drv->EndReceive();
+				//   }
+
+				// open the next frame; returns its length ( FCS included ) or 0
+				// if none ( frames with invalid flags are released )
+				uint16_t BeginReceive();
+
+				// status vector of the last opened frame
+				const RxStatusVector& GetRxStatusVector() const;
+
+				// read up to len bytes at offset off of the opened frame;
+				// returns the number of bytes read
+				uint16_t ReadReceived(uint16_t off, byte *buf, uint16_t len);
+				byte ReadReceived(uint16_t off);
+
+				// release the opened frame ( ERXRDPT advanced, PKTDEC )
+				void EndReceive();
 				
 				bool Transmit(const byte *buf, uint16_t len);
+
+				// Streaming transmit
+				// ~~~~~~~~~~~~~~~~~~
+				// the frame is serialized directly into the enc28j60 tx buffer
+				// as its pieces are produced
+				//
+				//   drv->BeginTransmit();
+				//   drv->WriteTransmit(hdr, sizeof(hdr));
+				//   drv->WriteTransmit(payload, payloadLen);
+				//   drv->PatchTransmit(24, (byte *)&chksum, 2);
+				//   drv->EndTransmit();
+
+				// start a new frame in a free tx slot, waiting for one if all
+				// are queued ( discards any frame not yet committed ); false if
+				// the controller isn't configured yet ( see PollInit )
+				bool BeginTransmit();
+
+				// append len bytes to the frame; returns the number of bytes
+				// written ( less than len if ETH_TX_CAPACITY exceeded )
+				uint16_t WriteTransmit(const byte *buf, uint16_t len);
+
+				// append all the segments with a single WBM; returns the number
+				// of bytes written ( 0 if they don't fit entirely )
+				uint16_t WriteTransmit(const TxSegment *segs, byte count);
+
+				// overwrite len bytes at offset off of the bytes already written
+				bool PatchTransmit(uint16_t off, const byte *buf, uint16_t len);
+
+				// send the frame and wait its completion
+				bool EndTransmit();
+
+				// Asynchronous transmit
+				// ~~~~~~~~~~~~~~~~~~~~~
+				// StartTransmit returns as soon as the frame is handed to the
+				// MAC; Receive can be used while it's on the wire
+				//
+				//   drv->StartTransmit(buf, len);
+				//   while (drv->PollTransmit() == TxPending) { ... drv->Receive(...) ... }
+
+				// queue the frame opened with BeginTransmit without waiting; it
+				// goes on the wire as soon as the frames before it are sent
+				bool StartTransmit();
+				bool StartTransmit(const byte *buf, uint16_t len);
+
+				// advances the tx queue ( next slot started when the current
+				// one completes ); TxPending while frames are queued, then
+				// TxFailed if any of the frames started since the last report
+				// failed, TxDone otherwise; once reported TxIdle. An aborted
+				// frame is sent again up to ETH_TX_RETRIES times,
+				// ETH_TX_RETRY_MS apart, before being counted as failed.
+				// Receive and Transmit advance the queue without consuming the
+				// report ( Transmit returns the outcome of its own frame ).
+				TxStateEnum PollTransmit();
+
+				// blocks until the tx queue is empty, then reports as PollTransmit
+				TxStateEnum WaitTransmit();
+
+				// tx slots available to BeginTransmit without waiting
+				byte TxSlotsFree() const;
+
+				// Asynchronous buffer transfer
+				// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+				// the RBM/WBM of a payload is started and the call returns
+				// while the transport moves it ( SPI DMA ), so that checksums
+				// or application work overlap the SPI copy. done( ctx, ok ) is
+				// called from the transport completion ( possibly an interrupt );
+				// any other call, of any driver, waits the transfer first
+				// ( the bus is held, see xferDriver ). Transports without
+				// background transfers complete it before returning.
+				//
+				//   auto len = drv->BeginReceive();
+				//   drv->StartReadReceived(0, buf, len - 4);
+				//   ... process the previous frame ...
+				//   if (!drv->WaitTransfer()) ... // aborted
+				//   drv->EndReceive();
+				//
+				//   drv->BeginTransmit();
+				//   drv->StartWriteTransmit(payload, payloadLen);
+				//   ... checksum of the next payload ...
+				//   drv->StartTransmit();
+
+				// same as ReadReceived and WriteTransmit; buf must stay valid
+				// until the transfer completes
+				uint16_t StartReadReceived(uint16_t off, byte *buf, uint16_t len,
+					SpiDoneCallback done = NULL, void *ctx = NULL);
+				uint16_t StartWriteTransmit(const byte *buf, uint16_t len,
+					SpiDoneCallback done = NULL, void *ctx = NULL);
+
+				// true while the started transfer is moving
+				bool TransferBusy();
+
+				// blocks until the started transfer completes; false if it
+				// was aborted ( data not moved )
+				bool WaitTransfer();
+
+				// DMA copy
+				// ~~~~~~~~
+				// moves received data into the frame being transmitted inside
+				// the enc28j60 ( echo replies, forwarding ) : only the fields
+				// that change need to cross the SPI bus
+				//
+				//   auto len = drv->BeginReceive();
+				//   drv->BeginTransmit();
+				//   drv->CopyReceived(0, len - 4, 0); // FCS excluded
+				//   drv->PatchTransmit(0, srcMac, 6);
+				//   ...
+				//   drv->EndReceive();
+				//   drv->EndTransmit();
+
+				// copy len bytes at offset off of the opened received frame to
+				// offset dstOff ( <= bytes already written ) of the frame being
+				// written, extending it if needed; returns the bytes copied
+				uint16_t CopyReceived(uint16_t off, uint16_t len, uint16_t dstOff);
+
+				// Checksum
+				// ~~~~~~~~
+				// one's complement checksum ( as in IP, ICMP, UDP, TCP headers )
+				// of the enc28j60 buffer memory, read over SPI or computed by
+				// its DMA ( see ETH_SOFT_CHECKSUM ); the checksum field in the
+				// range must be zero. partial is added to the sum ( ie. the not
+				// inverted sum of an UDP pseudo header ). #E15 : with the DMA,
+				// frames arriving meanwhile can be lost
+
+				// checksum of len bytes at offset off of the frame being written
+				// ( BeginTransmit )
+				uint16_t TxChecksum(uint16_t off, uint16_t len, uint16_t partial = 0);
+
+				// same as TxChecksum and the result stored ( big endian ) at
+				// offset csumOff of the frame
+				bool PatchTxChecksum(uint16_t off, uint16_t len, uint16_t csumOff, uint16_t partial = 0);
+
+				// checksum of len bytes at offset off of the opened received
+				// frame ( BeginReceive ), 0 if out of it
+				uint16_t RxChecksum(uint16_t off, uint16_t len, uint16_t partial = 0);
+
+				// asynchronous form : start the DMA over len bytes at buffer
+				// address start ( rx ring wrap handled ), poll DmaBusy() then
+				// read DmaChecksum(); #E15 applies here regardless of
+				// ETH_SOFT_CHECKSUM
+				bool StartDmaChecksum(uint16_t start, uint16_t len);
+				bool DmaBusy();
+				uint16_t DmaChecksum();
+
+				// Receive filters
+				// ~~~~~~~~~~~~~~~
+				// default : CRC check, unicast to MacAddress and broadcast ARP
+				// by pattern match
+				//
+				//   // accept unicast only if UDP to port 50000 ( AND mode )
+				//   PatternFilter f;
+				//   f.Match16(12, 0x0800);
+				//   f.Match8(23, 17);
+				//   f.Match16(36, 50000);
+				//   drv->SetPatternFilter(f);
+				//   drv->SetRxFilter(ETH_ERXFCON_CRCEN | ETH_ERXFCON_ANDOR |
+				//     ETH_ERXFCON_UCEN | ETH_ERXFCON_PMEN);
+
+				// reg. #8-1 - enabled filters ( ETH_ERXFCON_* ), frames accepted
+				// if any matches ( OR ) or all match ( ETH_ERXFCON_ANDOR ); 0
+				// accepts all. HTEN stays set while multicast groups are joined,
+				// except in AND mode where it's left as given
+				void SetRxFilter(byte erxfcon);
+				byte RxFilter() const;
+
+				// #8.2 - pattern used by ETH_ERXFCON_PMEN
+				void SetPatternFilter(const PatternFilter& filter);
+
+				// #8.4 - accept frames to the given multicast MAC address through
+				// the hash table filter ( ETH_ERXFCON_HTEN enabled while groups
+				// are joined ); joins are counted, so the group is left when each
+				// JoinMulticast got its LeaveMulticast. The hash table can let
+				// through other addresses sharing the same hash bit.
+				// false if ETH_MCAST_GROUPS are already joined or the filters
+				// are in AND mode ( ETH_ERXFCON_ANDOR )
+				bool JoinMulticast(const byte *mac);
+				// false if the group wasn't joined
+				bool LeaveMulticast(const byte *mac);
+
+				// Interrupt mode
+				// ~~~~~~~~~~~~~~
+				// the INT pin ( see DPIN_INT ) signals received frames, link
+				// changes and tx events; Receive and PollTransmit do no SPI
+				// traffic until the isr fires
+				//
+				//   drv->EnableInterrupt(DPIN_INT);
+
+				// false if ETH_INT_INSTANCES drivers already use it or the pin
+				// has no external interrupt ( digitalPinToInterrupt )
+				bool EnableInterrupt(byte intPin);
+				void DisableInterrupt();
+
+				// true if the isr fired since the last Receive/PollTransmit
+				bool InterruptPending() const;
+
+				// Buffer layout
+				// ~~~~~~~~~~~~~
+
+				uint16_t RxBufferSize() const;
+				byte TxSlots() const;
+
+				// scratch region reserved by the BufferLayout ( free for
+				// application use, untouched by the driver )
+				uint16_t ScratchBegin() const;
+				uint16_t ScratchSize() const;
+
+				// read/write len bytes at offset off of the scratch region;
+				// false if out of it
+				bool ReadScratch(uint16_t off, byte *buf, uint16_t len);
+				bool WriteScratch(uint16_t off, const byte *buf, uint16_t len);
+
+				// scatter-gather transmit : frame made of count segments from
+				// RAM or flash ( ie. header built in RAM + payload elsewhere )
+				//
+				//   TxSegment segs[] = { { hdr, sizeof(hdr), false }, { msg, msgLen, true } };
+				//   drv->Transmit(segs, 2);
+				bool Transmit(const TxSegment *segs, byte count);
+
+#if defined DEBUG && defined DEBUG_ETH_SPI
+				// SPI transactions spent by the last Receive that returned a frame
+				uint16_t LastRxTransactions() const;
+#endif
+
+#if defined DEBUG && defined DEBUG_ETH_BENCH
+				// print buffer memory throughput of a full size frame
+				void BenchBufferMemory();
+#endif
 				
 			};
 
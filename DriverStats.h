@@ -0,0 +1,68 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef _SEARCHATHING_ARDUINO_ENC28J60_DRIVERSTATS_H
+#define _SEARCHATHING_ARDUINO_ENC28J60_DRIVERSTATS_H
+
+#if defined(ARDUINO) && ARDUINO >= 100
+#include "arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			// driver counters ( see Driver::Stats ); they wrap on overflow.
+			// rxOverflows is sampled when EIR is read : LineStatus, interrupt
+			// service and, polling, each time receive finds new frames
+			struct DriverStats
+			{
+				uint32_t rxFrames;				// delivered to the app
+				uint32_t rxBytes;
+				uint32_t txFrames;				// #7-1 txDone
+				uint32_t txBytes;
+				uint32_t spiTransactions;		// CS assertions
+				uint16_t rxCrcErrors;			// #7-3 bit 20
+				uint16_t rxLengthErrors;		// #7-3 bit 21
+				uint16_t rxDropped;				// len > capacity
+				uint16_t rxResets;				// #11.4 on a corrupted ring ( not the warm restart flush )
+				uint16_t rxOverflows;			// #12.1.2 RXERIF, see above
+				uint16_t txAborts;				// #12.1.3 TXERIF or !txDone
+				uint16_t txLateCollisions;		// #7-1 bit 29
+				uint16_t txCollisions;			// #7-1 bits 19-16
+			};
+
+		}
+
+	}
+
+}
+
+#endif
@@ -26,17 +26,12 @@
 //===========================================================================
 // Setup()
 //   - Allocate the enc28j60 driver
-//   - Allocate the network infrastructure manager
-//   - SRUDP listener
-//		- Create a listener using current IP address as server endpoint
-//      - Associate an handler for client connections
-//      - Activate listener process
-//      - Register the listener process to the network subsystem
 // Loop()
-//   - Maintenance loop routine to keep working default packet handlers
-//     (arp, icmp, ...)
-//		- listener process is included because registered into the network
-//        subsystem
+//   - Advance the driver init one step, without blocking
+//   - Once ready allocate the network infrastructure manager
+//   - SRUDP listener
+//		- Wait a client connection on the current IP address
+//      - Echo its data back up to the disconnect
 //---------------------------------------------------------------------------
 // Suggested defines for this example
 //---------------------------------------------------------------------------
@@ -44,7 +39,7 @@
 //
 
 // SearchAThing.Arduino debug macro definitions
-#include <SearchAThing.Arduino.Utils\DebugMacros.h>
+#include <SearchAThing.Arduino.Utils/DebugMacros.h>
 
 //---------------------------------------------------------------------------
 // Libraries
@@ -52,13 +47,13 @@
 #include <MemoryFree.h>
 #include <SPI.h>
 
-#include <SearchAThing.Arduino.Utils\Util.h>
+#include <SearchAThing.Arduino.Utils/Util.h>
 using namespace SearchAThing::Arduino;
 
-#include <SearchAThing.Arduino.Net\EthNet.h>
+#include <SearchAThing.Arduino.Net/EthNet.h>
 using namespace SearchAThing::Arduino::Net;
 
-#include <SearchAThing.Arduino.Net\SRUDP_Client.h>
+#include <SearchAThing.Arduino.Net/SRUDP_Client.h>
 using namespace SearchAThing::Arduino::Net::SRUDP;
 
 #include "Driver.h"
@@ -69,61 +64,75 @@ using namespace SearchAThing::Arduino::Enc28j60;
 //---------------------------------------------------------------------------
 
 // network card driver
-EthDriver *drv;
+Driver *drv;
 
-// network manager
-EthNet *net;
+// network manager ( created once the driver is ready )
+EthNet *net = NULL;
 
 //---------------------------------------------------------------------------
 // Setup
 //---------------------------------------------------------------------------
 void setup()
 {
-	// init
-	{
-		{
-			// network card init ( mac = 00:00:6c:00:00:[01] )
-			drv = new Driver(PrivateMACAddress(1));
+	// network card init ( mac = 00:00:6c:00:00:[01] ); the constructor
+	// returns within ETH_INIT_TIMEOUT_MS, link or not
+	drv = new Driver(PrivateMACAddress(1));
+}
 
-			// network manager init [dynamic-mode]
-			net = new EthNet(drv);
-		}
+//---------------------------------------------------------------------------
+// Network
+//---------------------------------------------------------------------------
 
-		DPrint(F("MAC\t")); DPrintHexBytesln(net->MacAddress());
-		net->PrintSettings(); // print network settings
+// one driver init step per call : true once the network manager is up
+// ( created with the link, DHCP starts right away )
+bool NetReady()
+{
+	if (net != NULL) return true;
 
-		DPrintln(F("setup done"));
-		DNewline();
+	if (drv->PollInit() != InitReady)
+	{
+		if (drv->InitState() == InitFailed) drv->Reinit(); // not responding
+		return false;
 	}
 
-	//
+	// network manager init [dynamic-mode]
+	net = new EthNet(drv);
+
+	DPrint(F("MAC\t")); DPrintHexBytesln(net->MacAddress());
+	net->PrintSettings(); // print network settings
+
+	DPrintln(F("setup done"));
+	DNewline();
 
+	return true;
+}
+
+// serves one client up to its disconnect
+void EchoClient()
+{
 	IPEndPoint remoteEndPoint = IPEndPoint(net->IpAddress(), 50000);
 
-	while (true)
-	{
-		auto client = Client::Listen(net, remoteEndPoint);
+	auto client = Client::Listen(net, remoteEndPoint);
 
-		DPrint(F("client connected: ")); client.RemoteEndPoint().ToString().PrintAsChars(); DNewline();
+	DPrint(F("client connected: ")); client.RemoteEndPoint().ToString().PrintAsChars(); DNewline();
 
-		while (client.State() == ClientState::Connected)
+	while (client.State() == ClientState::Connected)
+	{
+		RamData data;
+		if (client.Read(data) == TransactionResult::Successful)
 		{
-			RamData data;
-			if (client.Read(data) == TransactionResult::Successful)
-			{
-				DPrint(F("Received [")); data.PrintAsChars(); DPrintln(F("]"));
+			DPrint(F("Received [")); data.PrintAsChars(); DPrintln(F("]"));
 
-				while (client.Write(data) != TransactionResult::Successful)
-				{
-					DPrintln(F("write failed"));
-				}
+			while (client.Write(data) != TransactionResult::Successful)
+			{
+				DPrintln(F("write failed"));
 			}
 		}
+	}
 
-		DPrintln(F("client received a disconnect"));
+	DPrintln(F("client received a disconnect"));
 
-		PrintFreeMemory();
-	}
+	PrintFreeMemory();
 }
 
 //---------------------------------------------------------------------------
@@ -131,7 +140,13 @@ void setup()
 //---------------------------------------------------------------------------
 void loop()
 {
+	// the rest of the sketch keeps running while the link comes up
+	if (!NetReady()) return;
+
+	EchoClient();
+
 	//net->Receive(); // receive packet ( if any )
 	//net->FlushRx(); // process packet using registered default handlers,
 	// then discard it
 }
+
@@ -0,0 +1,107 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include <SearchAThing.Arduino.Net/Protocol.h>
+
+#include "InitScript.h"
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			const RegWrite InitRegsDefault[] PROGMEM =
+			{
+				// #6.5.1
+				{ ETH_MACON1, ETH_MACON1_TXPAUS | ETH_MACON1_RXPAUS | ETH_MACON1_MARXEN },
+				// #6.5.2
+				{ ETH_MACON3, ETH_MACON3_PADCFG0 | ETH_MACON3_TXCRCEN | ETH_MACON3_FRMLNEN | ETH_MACON3_FULDPX },
+				// #6.5.5
+				{ ETH_MABBIPG, 0x15 },
+				// #6.5.6
+				{ ETH_MAIPGL, 0x12 },
+				// #6.5.7
+				{ ETH_MAIPGH, 0x0C },
+				// #6.5.4
+				{ ETH_MAMXFL, lowByte(MAX_FRAME_LENGTH) },
+				{ ETH_MAMXFH, highByte(MAX_FRAME_LENGTH) }
+			};
+
+			const PhyRegWrite InitPhyRegsDefault[] PROGMEM =
+			{
+				// #6.6
+				{ ETH_PHCON2, ETH_PHCON2_HDLDIS }
+			};
+
+			const InitScript InitScriptDefault =
+			{
+				InitRegsDefault, sizeof(InitRegsDefault) / sizeof(RegWrite),
+				InitPhyRegsDefault, sizeof(InitPhyRegsDefault) / sizeof(PhyRegWrite)
+			};
+
+			const RegWrite InitRegsHalfDuplex[] PROGMEM =
+			{
+				// #6.5.1
+				{ ETH_MACON1, ETH_MACON1_MARXEN },
+				// #6.5.2
+				{ ETH_MACON3, ETH_MACON3_PADCFG0 | ETH_MACON3_TXCRCEN | ETH_MACON3_FRMLNEN },
+				// #6.5.3
+				{ ETH_MACON4, ETH_MACON4_DEFER },
+				// #6.5.5
+				{ ETH_MABBIPG, 0x12 },
+				// #6.5.6
+				{ ETH_MAIPGL, 0x12 },
+				// #6.5.7
+				{ ETH_MAIPGH, 0x0C },
+				// #6.5.4
+				{ ETH_MAMXFL, lowByte(MAX_FRAME_LENGTH) },
+				{ ETH_MAMXFH, highByte(MAX_FRAME_LENGTH) }
+			};
+
+			const PhyRegWrite InitPhyRegsHalfDuplex[] PROGMEM =
+			{
+				// #6.6
+				{ ETH_PHCON1, 0 },
+				{ ETH_PHCON2, ETH_PHCON2_HDLDIS }
+			};
+
+			const InitScript InitScriptHalfDuplex =
+			{
+				InitRegsHalfDuplex, sizeof(InitRegsHalfDuplex) / sizeof(RegWrite),
+				InitPhyRegsHalfDuplex, sizeof(InitPhyRegsHalfDuplex) / sizeof(PhyRegWrite)
+			};
+
+		}
+
+	}
+
+}
@@ -0,0 +1,90 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#ifndef _SEARCHATHING_ARDUINO_ENC28J60_INITSCRIPT_H
+#define _SEARCHATHING_ARDUINO_ENC28J60_INITSCRIPT_H
+
+#if defined(ARDUINO) && ARDUINO >= 100
+#include "arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+#include "Registers.h"
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			// control register write ( PROGMEM )
+			struct RegWrite
+			{
+				byte craddress;
+				byte value;
+			};
+
+			// #3.3.2 - PHY register write ( PROGMEM )
+			struct PhyRegWrite
+			{
+				byte praddress;
+				uint16_t value;
+			};
+
+			// constant part of the controller configuration replayed by the
+			// driver at init and warm restart; regs are written in order
+			// ( sort them by bank so that each one is selected once ), then PHY
+			// writes, each one waiting MISTAT.BUSY ( bank 3 ) of the previous.
+			// Set by the driver out of the script : buffer pointers ( bank 0,
+			// BufferLayout ), rx filter ( bank 1, SetRxFilter ), MAC address
+			// ( bank 3 ) and the PHY link interrupt ( PHIE )
+			struct InitScript
+			{
+				const RegWrite *regs;
+				byte regCount;
+				const PhyRegWrite *phyRegs;
+				byte phyRegCount;
+			};
+
+			// #6.5 - full-duplex MAC, PHY duplex left to the LEDB strap ( #2.6 )
+			extern const InitScript InitScriptDefault;
+
+			// #6.5 - half-duplex MAC and PHY
+			extern const InitScript InitScriptHalfDuplex;
+
+		}
+
+	}
+
+}
+
+#endif
@@ -0,0 +1,99 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "PatternFilter.h"
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			PatternFilter::PatternFilter(uint16_t _offset)
+			{
+				offset = _offset;
+				memset(mask, 0, sizeof(mask));
+				memset(data, 0, sizeof(data));
+			}
+
+			bool PatternFilter::Match(uint16_t off, const byte *buf, byte len)
+			{
+				if (off < offset || off + len > offset + ETH_PATTERN_WINDOW) return false;
+
+				for (byte i = 0; i < len; ++i)
+				{
+					byte j = off - offset + i;
+					data[j] = buf[i];
+					mask[j / 8] |= (1 << (j % 8));
+				}
+
+				return true;
+			}
+
+			bool PatternFilter::Match8(uint16_t off, byte value)
+			{
+				return Match(off, &value, 1);
+			}
+
+			bool PatternFilter::Match16(uint16_t off, uint16_t value)
+			{
+				byte b[2] = { highByte(value), lowByte(value) };
+
+				return Match(off, b, 2);
+			}
+
+			uint16_t PatternFilter::Offset() const { return offset; }
+
+			const byte *PatternFilter::Mask() const { return mask; }
+
+			// #8.2 - IP checksum of the selected bytes taken in sequence
+			uint16_t PatternFilter::Checksum() const
+			{
+				uint32_t sum = 0;
+				byte idx = 0;
+
+				for (byte i = 0; i < ETH_PATTERN_WINDOW; ++i)
+				{
+					if (!(mask[i / 8] & (1 << (i % 8)))) continue;
+
+					sum += (idx++ % 2 == 0) ? ((uint16_t)data[i] << 8) : data[i];
+				}
+
+				while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+
+				return ~sum;
+			}
+
+		}
+
+	}
+
+}
@@ -0,0 +1,96 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#ifndef _SEARCHATHING_ARDUINO_ENC28J60_PATTERNFILTER_H
+#define _SEARCHATHING_ARDUINO_ENC28J60_PATTERNFILTER_H
+
+#if defined(ARDUINO) && ARDUINO >= 100
+#include "arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+// #8.2 - pattern match window size
+#define ETH_PATTERN_WINDOW	64
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			// #8.2 - pattern match filter builder : the bytes to match are
+			// given at their frame offset ( from the destination address ) and
+			// must fall in the 64 bytes window that starts at the given offset
+			// ( frames shorter than the window end never match ); mask and
+			// checksum are computed from them ( see Driver::SetPatternFilter )
+			//
+			//   // UDP to port 50000 only
+			//   PatternFilter f;
+			//   f.Match16(12, 0x0800);	// ethertype IPv4
+			//   f.Match8(23, 17);		// ip protocol UDP
+			//   f.Match16(36, 50000);	// udp dst port ( ip header without options )
+			class PatternFilter
+			{
+
+			private:
+				// window offset
+				uint16_t offset;
+
+				// #8-3 - bit i selects the byte offset+i
+				byte mask[ETH_PATTERN_WINDOW / 8];
+				byte data[ETH_PATTERN_WINDOW];
+
+			public:
+				PatternFilter(uint16_t _offset = 0);
+
+				// match len bytes at frame offset off; false if outside the window
+				bool Match(uint16_t off, const byte *buf, byte len);
+				bool Match8(uint16_t off, byte value);
+				// value in network byte order
+				bool Match16(uint16_t off, uint16_t value);
+
+				// EPMO
+				uint16_t Offset() const;
+				// EPMM0..7
+				const byte *Mask() const;
+				// EPMCS
+				uint16_t Checksum() const;
+
+			};
+
+		}
+
+	}
+
+}
+
+#endif
@@ -35,7 +35,7 @@
 #include "WProgram.h"
 #endif
 
-#include <SearchAThing.Arduino.Utils\DebugMacros.h>
+#include <SearchAThing.Arduino.Utils/DebugMacros.h>
 
 //----------------------------------------------------------------------
 
@@ -260,22 +260,94 @@ namespace SearchAThing
 			// #7.2.4: RX Buffer Read Pointer [REGISTER] (high byte)
 			const byte ETH_ERXRDPTH = 0x0D;
 
+			// #13: DMA Start [REGISTER] (low byte)
+			const byte ETH_EDMASTL = 0x10;
+
+			// #13: DMA Start [REGISTER] (high byte)
+			const byte ETH_EDMASTH = 0x11;
+
+			// #13: DMA End [REGISTER] (low byte)
+			const byte ETH_EDMANDL = 0x12;
+
+			// #13: DMA End [REGISTER] (high byte)
+			const byte ETH_EDMANDH = 0x13;
+
+			// #13.1: DMA Destination [REGISTER] (low byte)
+			const byte ETH_EDMADSTL = 0x14;
+
+			// #13.1: DMA Destination [REGISTER] (high byte)
+			const byte ETH_EDMADSTH = 0x15;
+
+			// #13.2: DMA Checksum [REGISTER] (low byte)
+			const byte ETH_EDMACSL = 0x16;
+
+			// #13.2: DMA Checksum [REGISTER] (high byte)
+			const byte ETH_EDMACSH = 0x17;
+
 			//----------------------------------------------------------
 			// Bank1 banks registers
 			//----------------------------------------------------------
 
+			// #8.4: Hash Table [REGISTER] byte 0
+			const byte ETH_EHT0 = (ETH_BANK1 | 0x00);
+
+			// #8.4: Hash Table [REGISTER] byte 1
+			const byte ETH_EHT1 = (ETH_BANK1 | 0x01);
+
+			// #8.4: Hash Table [REGISTER] byte 2
+			const byte ETH_EHT2 = (ETH_BANK1 | 0x02);
+
+			// #8.4: Hash Table [REGISTER] byte 3
+			const byte ETH_EHT3 = (ETH_BANK1 | 0x03);
+
+			// #8.4: Hash Table [REGISTER] byte 4
+			const byte ETH_EHT4 = (ETH_BANK1 | 0x04);
+
+			// #8.4: Hash Table [REGISTER] byte 5
+			const byte ETH_EHT5 = (ETH_BANK1 | 0x05);
+
+			// #8.4: Hash Table [REGISTER] byte 6
+			const byte ETH_EHT6 = (ETH_BANK1 | 0x06);
+
+			// #8.4: Hash Table [REGISTER] byte 7
+			const byte ETH_EHT7 = (ETH_BANK1 | 0x07);
+
 			// #8.2: Pattern Match Mask [REGISTER] byte 0
 			const byte ETH_EPMM0 = (ETH_BANK1 | 0x08);
 
 			// #8.2: Pattern Match Mask [REGISTER] byte 1
 			const byte ETH_EPMM1 = (ETH_BANK1 | 0x09);
 
+			// #8.2: Pattern Match Mask [REGISTER] byte 2
+			const byte ETH_EPMM2 = (ETH_BANK1 | 0x0A);
+
+			// #8.2: Pattern Match Mask [REGISTER] byte 3
+			const byte ETH_EPMM3 = (ETH_BANK1 | 0x0B);
+
+			// #8.2: Pattern Match Mask [REGISTER] byte 4
+			const byte ETH_EPMM4 = (ETH_BANK1 | 0x0C);
+
+			// #8.2: Pattern Match Mask [REGISTER] byte 5
+			const byte ETH_EPMM5 = (ETH_BANK1 | 0x0D);
+
+			// #8.2: Pattern Match Mask [REGISTER] byte 6
+			const byte ETH_EPMM6 = (ETH_BANK1 | 0x0E);
+
+			// #8.2: Pattern Match Mask [REGISTER] byte 7
+			const byte ETH_EPMM7 = (ETH_BANK1 | 0x0F);
+
 			// #8.2: Pattern Match Checksum [REGISTER] (low byte)
 			const byte ETH_EPMCSL = (ETH_BANK1 | 0x10);
 
 			// #8.2: Pattern Match Checksum [REGISTER] (high byte)
 			const byte ETH_EPMCSH = (ETH_BANK1 | 0x11);
 
+			// #8.2: Pattern Match Offset [REGISTER] (low byte)
+			const byte ETH_EPMOL = (ETH_BANK1 | 0x14);
+
+			// #8.2: Pattern Match Offset [REGISTER] (high byte)
+			const byte ETH_EPMOH = (ETH_BANK1 | 0x15);
+
 			// reg. #8-1: Ehternet Receive Filter Control [REGISTER]
 			const byte ETH_ERXFCON = (ETH_BANK1 | 0x18);
 			// Unicast Filter Enable
@@ -322,6 +394,11 @@ namespace SearchAThing
 			// MAC Full-Duplex Enable
 			const byte ETH_MACON3_FULDPX = (1 << 0);
 
+			// reg. #6-4: MAC Control [REGISTER] 4
+			const byte ETH_MACON4 = (ETH_MAC_MII_FLAG | ETH_BANK2 | 0x03);
+			// Defer Transmission Enable ( half-duplex )
+			const byte ETH_MACON4_DEFER = (1 << 6);
+
 			// #6.5: Maximum Frame Length [REGISTER] (low byte)
 			const byte ETH_MAMXFL = (ETH_MAC_MII_FLAG | ETH_BANK2 | 0x0A);
 			// #6.5: Maxumyn Frame Length [REGISTER] (high byte)
@@ -379,7 +456,7 @@ namespace SearchAThing
 			const byte ETH_MAADR2 = (ETH_MAC_MII_FLAG | ETH_BANK3 | 0x05);
 
 			// reg. #3-4: MII Status [REGISTER]
-			const byte ETH_MISTAT = (ETH_BANK3 | 0x0A);
+			const byte ETH_MISTAT = (ETH_MAC_MII_FLAG | ETH_BANK3 | 0x0A);
 			// MII Management Busy
 			const byte ETH_MISTAT_BUSY = (1 << 0);
 
@@ -390,6 +467,8 @@ namespace SearchAThing
 			const byte ETH_PHCON1 = (0x00);
 			// PHY Loopback bit
 			const uint16_t ETH_PHCON1_PLOOPBK = (1 << 14);
+			// PHY Duplex Mode bit
+			const uint16_t ETH_PHCON1_PDPXMD = (1 << 8);
 
 			// reg. #3-5: Physical Layer Status [REGISTER] 1
 			const byte ETH_PHSTAT1 = (0x01);
@@ -406,6 +485,13 @@ namespace SearchAThing
 			// PHY Link Status bit (non-latching)
 			const uint16_t ETH_PHSTAT2_LSTAT = (1 << 10);
 
+			// reg. #12-4: PHY Interrupt Enable [REGISTER]
+			const byte ETH_PHIE = (0x12);
+			// PHY Link Change Interrupt Enable
+			const uint16_t ETH_PHIE_PLNKIE = (1 << 4);
+			// PHY Global Interrupt Enable
+			const uint16_t ETH_PHIE_PGEIE = (1 << 1);
+
 			// reg. #12-5: PHY Interrupt Request (flag) [REGISTER]
 			const byte ETH_PHIR = (0x13);
 			// Link Change Interrupt
@@ -0,0 +1,289 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "SpiTransport.h"
+
+#if defined(__AVR__)
+#include <util/atomic.h>
+#endif
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			//==========================================================
+			// SpiTransport
+			//==========================================================
+
+			void SpiTransport::Write(byte data)
+			{
+				Transfer(data);
+			}
+
+			void SpiTransport::ReadBlock(byte *data, uint16_t len)
+			{
+				while (len--) *data++ = Transfer(0);
+			}
+
+			void SpiTransport::WriteBlock(const byte *data, uint16_t len)
+			{
+				while (len--) Transfer(*data++);
+			}
+
+			void SpiTransport::WriteBlock_P(const byte *data, uint16_t len)
+			{
+				while (len--) Transfer(pgm_read_byte(data++));
+			}
+
+			void SpiTransport::StartReadBlock(byte *data, uint16_t len, SpiDoneCallback done, void *ctx)
+			{
+				ReadBlock(data, len);
+				done(ctx, true);
+			}
+
+			void SpiTransport::StartWriteBlock(const byte *data, uint16_t len, SpiDoneCallback done, void *ctx)
+			{
+				WriteBlock(data, len);
+				done(ctx, true);
+			}
+
+			void SpiTransport::Poll()
+			{
+			}
+
+			//==========================================================
+			// ArduinoSpiTransport
+			//==========================================================
+
+#define SPI_BLOCK_CHUNK 32
+
+			ArduinoSpiTransport::ArduinoSpiTransport(byte _csPin, uint32_t clock) :
+				settings(clock, MSBFIRST, SPI_MODE0)
+			{
+				csPin = _csPin;
+			}
+
+			void ArduinoSpiTransport::Begin()
+			{
+				// deselected before becoming an output
+				digitalWrite(csPin, HIGH);
+				pinMode(csPin, OUTPUT);
+#if defined(__AVR__)
+				csPort = portOutputRegister(digitalPinToPort(csPin));
+				csMask = digitalPinToBitMask(csPin);
+#endif
+
+				SPI.begin();
+			}
+
+			void ArduinoSpiTransport::Select()
+			{
+				SPI.beginTransaction(settings);
+#if defined(__AVR__)
+				// port read-modify-write instead of digitalWrite : not a single
+				// instruction outside the low I/O space, so an ISR writing the same
+				// port in between would be undone
+				ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+				{
+					*csPort &= ~csMask;
+				}
+#else
+				digitalWrite(csPin, LOW);
+#endif
+			}
+
+			void ArduinoSpiTransport::Deselect()
+			{
+#if defined(__AVR__)
+				ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+				{
+					*csPort |= csMask;
+				}
+#else
+				digitalWrite(csPin, HIGH);
+#endif
+				SPI.endTransaction();
+			}
+
+			byte ArduinoSpiTransport::Transfer(byte data)
+			{
+				return SPI.transfer(data);
+			}
+
+			void ArduinoSpiTransport::Write(byte data)
+			{
+				SPI.transfer(data);
+			}
+
+			void ArduinoSpiTransport::ReadBlock(byte *data, uint16_t len)
+			{
+				memset(data, 0, len);
+				SPI.transfer(data, len);
+			}
+
+			void ArduinoSpiTransport::WriteBlock(const byte *data, uint16_t len)
+			{
+				// transfer(buf, count) overwrites buf with received data
+				byte chunk[SPI_BLOCK_CHUNK];
+
+				while (len)
+				{
+					uint16_t n = len < SPI_BLOCK_CHUNK ? len : SPI_BLOCK_CHUNK;
+					memcpy(chunk, data, n);
+					SPI.transfer(chunk, n);
+					data += n;
+					len -= n;
+				}
+			}
+
+			void ArduinoSpiTransport::WriteBlock_P(const byte *data, uint16_t len)
+			{
+				byte chunk[SPI_BLOCK_CHUNK];
+
+				while (len)
+				{
+					uint16_t n = len < SPI_BLOCK_CHUNK ? len : SPI_BLOCK_CHUNK;
+					for (uint16_t i = 0; i < n; ++i) chunk[i] = pgm_read_byte(data++);
+					SPI.transfer(chunk, n);
+					len -= n;
+				}
+			}
+
+#if defined(SPI_HAS_TRANSFER_ASYNC)
+
+			void ArduinoSpiTransport::EventDone(EventResponderRef ev)
+			{
+				auto t = (ArduinoSpiTransport *)ev.getContext();
+				t->done(t->doneCtx, true);
+			}
+
+			void ArduinoSpiTransport::StartReadBlock(byte *data, uint16_t len, SpiDoneCallback _done, void *ctx)
+			{
+				done = _done;
+				doneCtx = ctx;
+				event.setContext(this);
+				event.attachImmediate(EventDone);
+
+				// tx NULL : the fill byte is clocked out
+				if (!SPI.transfer(NULL, data, len, event)) _done(ctx, false);
+			}
+
+			void ArduinoSpiTransport::StartWriteBlock(const byte *data, uint16_t len, SpiDoneCallback _done, void *ctx)
+			{
+				done = _done;
+				doneCtx = ctx;
+				event.setContext(this);
+				event.attachImmediate(EventDone);
+
+				if (!SPI.transfer(data, NULL, len, event)) _done(ctx, false);
+			}
+
+#endif
+
+#if defined(__AVR__)
+
+			//==========================================================
+			// AvrSpiTransport
+			//==========================================================
+
+			AvrSpiTransport::AvrSpiTransport(byte _csPin, uint32_t clock) :
+				ArduinoSpiTransport(_csPin, clock)
+			{
+			}
+
+			byte AvrSpiTransport::Transfer(byte data)
+			{
+				SPDR = data;
+				while (!(SPSR & _BV(SPIF)));
+				return SPDR;
+			}
+
+			void AvrSpiTransport::Write(byte data)
+			{
+				SPDR = data;
+				while (!(SPSR & _BV(SPIF)));
+			}
+
+			void AvrSpiTransport::ReadBlock(byte *data, uint16_t len)
+			{
+				if (len == 0) return;
+
+				SPDR = 0;
+				while (--len)
+				{
+					while (!(SPSR & _BV(SPIF)));
+					byte b = SPDR;
+					SPDR = 0;
+					*data++ = b;
+				}
+				while (!(SPSR & _BV(SPIF)));
+				*data = SPDR;
+			}
+
+			void AvrSpiTransport::WriteBlock(const byte *data, uint16_t len)
+			{
+				if (len == 0) return;
+
+				SPDR = *data++;
+				while (--len)
+				{
+					byte b = *data++;
+					while (!(SPSR & _BV(SPIF)));
+					SPDR = b;
+				}
+				while (!(SPSR & _BV(SPIF)));
+				(void)SPDR;
+			}
+
+			void AvrSpiTransport::WriteBlock_P(const byte *data, uint16_t len)
+			{
+				if (len == 0) return;
+
+				SPDR = pgm_read_byte(data++);
+				while (--len)
+				{
+					byte b = pgm_read_byte(data++);
+					while (!(SPSR & _BV(SPIF)));
+					SPDR = b;
+				}
+				while (!(SPSR & _BV(SPIF)));
+				(void)SPDR;
+			}
+
+#endif
+
+		}
+
+	}
+
+}
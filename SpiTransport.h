@@ -0,0 +1,220 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#ifndef _SEARCHATHING_ARDUINO_ENC28J60_SPITRANSPORT_H
+#define _SEARCHATHING_ARDUINO_ENC28J60_SPITRANSPORT_H
+
+#if defined(ARDUINO) && ARDUINO >= 100
+#include "arduino.h"
+#else
+#include "WProgram.h"
+#endif
+
+#include <SPI.h>
+
+// #4.1 - default chip select ( see Driver constructor )
+#ifndef DPIN_CS
+#define DPIN_CS				10
+#endif
+
+// #1 - max SCK frequency ( see Driver constructor )
+#ifndef ETH_SPI_CLOCK
+#define ETH_SPI_CLOCK		20000000
+#endif
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			// completion of an asynchronous block transfer ( ok false if the
+			// transfer was aborted )
+			typedef void (*SpiDoneCallback)(void *ctx, bool ok);
+
+			// #4 - SPI access to a controller : each command is a transaction
+			// between Select and Deselect; block functions stream RBM/WBM data
+			// ( #4.2.2, #4.2.4 ) inside an already opened transaction
+			class SpiTransport
+			{
+
+			public:
+				// transports are also deleted through this base
+				virtual ~SpiTransport() {}
+
+				// pins and bus setup
+				virtual void Begin() = 0;
+
+				virtual void Select() = 0;
+				virtual void Deselect() = 0;
+
+				virtual byte Transfer(byte data) = 0;
+				// received byte not needed : a transport may hold it back up to
+				// the next Transfer, block read or Deselect. Default Transfer
+				virtual void Write(byte data);
+
+				// defaults loop over Transfer
+				virtual void ReadBlock(byte *data, uint16_t len);
+				virtual void WriteBlock(const byte *data, uint16_t len);
+				// data in flash
+				virtual void WriteBlock_P(const byte *data, uint16_t len);
+
+				// start a block transfer and return without waiting it; done
+				// is called ( possibly from an interrupt ) once the data is
+				// moved and nothing else is issued until then. Defaults run
+				// the blocking form and call done before returning
+				virtual void StartReadBlock(byte *data, uint16_t len, SpiDoneCallback done, void *ctx);
+				virtual void StartWriteBlock(const byte *data, uint16_t len, SpiDoneCallback done, void *ctx);
+
+				// checks completions not reported by an interrupt
+				virtual void Poll();
+
+			};
+
+			// Arduino SPI library, blocks through SPI.transfer(buf, count)
+			// ( cores with FIFO/DMA backed transfers ); asynchronous blocks
+			// through the SPI DMA where the core provides it
+			// ( SPI_HAS_TRANSFER_ASYNC )
+			class ArduinoSpiTransport : public SpiTransport
+			{
+
+			protected:
+				// #4.1 - on AVR driven through its port register
+				byte csPin;
+#if defined(__AVR__)
+				volatile uint8_t *csPort;
+				uint8_t csMask;
+#endif
+				SPISettings settings;
+
+#if defined(SPI_HAS_TRANSFER_ASYNC)
+				// SPI DMA ( Teensy ) completion
+				EventResponder event;
+				SpiDoneCallback done;
+				void *doneCtx;
+				static void EventDone(EventResponderRef ev);
+#endif
+
+			public:
+				ArduinoSpiTransport(byte _csPin = DPIN_CS, uint32_t clock = ETH_SPI_CLOCK);
+
+				void Begin();
+				void Select();
+				void Deselect();
+				byte Transfer(byte data);
+				void Write(byte data);
+				void ReadBlock(byte *data, uint16_t len);
+				void WriteBlock(const byte *data, uint16_t len);
+				void WriteBlock_P(const byte *data, uint16_t len);
+
+#if defined(SPI_HAS_TRANSFER_ASYNC)
+				void StartReadBlock(byte *data, uint16_t len, SpiDoneCallback done, void *ctx);
+				void StartWriteBlock(const byte *data, uint16_t len, SpiDoneCallback done, void *ctx);
+#endif
+
+			};
+
+#if defined(__AVR__)
+
+			// SPDR driven directly : the next byte is queued as soon as SPIF
+			// reports the previous one so that SCK never idles between bytes
+			class AvrSpiTransport : public ArduinoSpiTransport
+			{
+
+			public:
+				AvrSpiTransport(byte _csPin = DPIN_CS, uint32_t clock = ETH_SPI_CLOCK);
+
+				byte Transfer(byte data);
+				void Write(byte data);
+				void ReadBlock(byte *data, uint16_t len);
+				void WriteBlock(const byte *data, uint16_t len);
+				void WriteBlock_P(const byte *data, uint16_t len);
+
+			};
+
+			typedef AvrSpiTransport DefaultSpiTransport;
+
+#else
+
+			typedef ArduinoSpiTransport DefaultSpiTransport;
+
+#endif
+
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__) || \
+	defined(__AVR_ATmega168P__) || defined(__AVR_ATmega88__) || defined(__AVR_ATmega48__)
+			// Uno class pinout : D0-D7 PORTD, D8-D13 PORTB, D14-D19 ( A0-A5 ) PORTC
+#define ETH_CS_FAST(pin)	((pin) < 20)
+#define ETH_CS_PORT(pin)	((pin) < 8 ? &PORTD : (pin) < 14 ? &PORTB : &PORTC)
+#define ETH_CS_BIT(pin)		((pin) < 8 ? (pin) : (pin) < 14 ? (pin) - 8 : (pin) - 14)
+#endif
+
+			// #4.1 - chip select known at compile time : on boards with a
+			// known pinout ( ETH_CS_FAST ) the port and bit are constants in
+			// the low I/O space, so CS toggles compile to a single sbi / cbi,
+			// atomic by themselves. A pin other than CsPin given at run time,
+			// or other boards, go through the DefaultSpiTransport path
+			template <byte CsPin>
+			class CsPinSpiTransport : public DefaultSpiTransport
+			{
+
+			public:
+				CsPinSpiTransport(byte _csPin = CsPin, uint32_t clock = ETH_SPI_CLOCK) :
+					DefaultSpiTransport(_csPin, clock)
+				{
+				}
+
+#if defined(ETH_CS_FAST)
+				void Select()
+				{
+					if (!ETH_CS_FAST(CsPin) || csPin != CsPin) { DefaultSpiTransport::Select(); return; }
+
+					SPI.beginTransaction(settings);
+					*ETH_CS_PORT(CsPin) &= ~_BV(ETH_CS_BIT(CsPin));
+				}
+
+				void Deselect()
+				{
+					if (!ETH_CS_FAST(CsPin) || csPin != CsPin) { DefaultSpiTransport::Deselect(); return; }
+
+					*ETH_CS_PORT(CsPin) |= _BV(ETH_CS_BIT(CsPin));
+					SPI.endTransaction();
+				}
+#endif
+
+			};
+
+		}
+
+	}
+
+}
+
+#endif
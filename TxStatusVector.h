@@ -30,8 +30,8 @@
 #include "WProgram.h"
 #endif
 
-#include <SearchAThing.Arduino.Utils\DebugMacros.h>
-#include <SearchAThing.Arduino.Utils\RamData.h>
+#include <SearchAThing.Arduino.Utils/DebugMacros.h>
+#include <SearchAThing.Arduino.Utils/RamData.h>
 
 namespace SearchAThing
 {
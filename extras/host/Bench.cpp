@@ -0,0 +1,216 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+//===========================================================================
+// HOST BENCH : measure SPI traffic of Driver receive and transmit
+//===========================================================================
+// Links Driver.cpp against the Emulator and reports, for some frame sizes,
+// the number of SPI transactions, bytes clocked and emulated time spent
+// by the driver, then the host cpu time of a receive + transmit cycle with
+// the driver reaching the Emulator through SpidevTransport ( EmulatorSpidev ),
+// and the emulated time of a frame read overlapped with application work
+// through the simulated SPI DMA ( EmulatorDmaSpi ) against the blocking read
+// ( then with the block aborted and read again ).
+// Exit code is non zero if a frame is not delivered intact.
+//---------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <chrono>
+
+#include "Driver.h"
+using namespace SearchAThing::Arduino::Enc28j60;
+
+#include "Emulator.h"
+#include "EmulatorDmaSpi.h"
+#include "EmulatorSpidev.h"
+#include "Host.h"
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+namespace
+{
+
+	const uint16_t sizes[] = { 60, 590, 1514 };
+
+	const int cycles = 1000;
+
+	// application work done while the frame is read ( async )
+	const uint32_t workUs = 100;
+
+	void Report(const char *what, uint16_t size, const Emulator& emu, uint64_t ns)
+	{
+		auto& c = emu.GetCounters();
+
+		printf("%-3s %5u bytes : %5u transactions %5u spi bytes %8.1f us\n",
+			what, size, c.transactions, c.bytes, ns / 1000.0);
+	}
+
+}
+
+int main()
+{
+	Emulator emu;
+	Attach(DPIN_CS, &emu);
+
+	byte mac[] = { 0x00, 0x00, 0x6c, 0x00, 0x00, 0x01 };
+	Driver drv(RamData(mac, sizeof(mac)));
+
+	static byte frame[MAX_FRAME_LENGTH];
+	static byte buf[MAX_FRAME_LENGTH];
+
+	memcpy(frame, mac, 6);
+	memset(frame + 6, 0x11, 6);
+	frame[12] = 0x08; frame[13] = 0x00;
+	for (uint16_t i = 14; i < sizeof(frame); ++i) frame[i] = (byte)i;
+
+	int res = 0;
+
+	for (auto size : sizes)
+	{
+		emu.Inject(frame, size);
+
+		emu.ClearCounters();
+		auto t = Nanos();
+
+		auto len = drv.Receive(buf, sizeof(buf));
+
+		Report("rx", size, emu, Nanos() - t);
+
+		// received length includes the FCS
+		if (len != size + 4 || memcmp(buf, frame, size) != 0) res = 1;
+	}
+
+	// zero-copy : only the eth2 + ipv4 headers leave the rx ring
+	for (auto size : sizes)
+	{
+		emu.Inject(frame, size);
+
+		emu.ClearCounters();
+		auto t = Nanos();
+
+		auto len = drv.BeginReceive();
+		auto hdr = drv.ReadReceived(0, buf, 34);
+		drv.EndReceive();
+
+		Report("rxz", size, emu, Nanos() - t);
+
+		if (len != size + 4 || hdr != 34 || memcmp(buf, frame, 34) != 0) res = 1;
+	}
+
+	for (auto size : sizes)
+	{
+		emu.ClearCounters();
+		auto t = Nanos();
+
+		auto ok = drv.Transmit(frame, size);
+
+		Report("tx", size, emu, Nanos() - t);
+
+		std::vector<byte> out;
+		if (!ok || !emu.PopTransmitted(out) || out.size() != size || memcmp(out.data(), frame, size) != 0) res = 1;
+	}
+
+	Emulator emuDev;
+	EmulatorSpidev spidev(&emuDev);
+	Driver drvDev(spidev, RamData(mac, sizeof(mac)));
+
+	for (auto size : sizes)
+	{
+		std::vector<byte> out;
+
+		auto t = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < cycles; ++i)
+		{
+			emuDev.Inject(frame, size);
+			if (drvDev.Receive(buf, sizeof(buf)) != size + 4) res = 1;
+
+			if (!drvDev.Transmit(frame, size) || !emuDev.PopTransmitted(out) || out.size() != size) res = 1;
+		}
+
+		std::chrono::duration<double, std::micro> us = std::chrono::steady_clock::now() - t;
+
+		printf("spidev %5u bytes : %8.2f us cpu per rx+tx\n", size, us.count() / cycles);
+	}
+
+	if (spidev.Errors() != 0) res = 1;
+
+	Emulator emuDma;
+	EmulatorDmaSpi dma(&emuDma);
+	Driver drvDma(dma, RamData(mac, sizeof(mac)));
+
+	for (auto size : sizes)
+	{
+		emu.Inject(frame, size);
+
+		auto t = Nanos();
+
+		auto len = drv.BeginReceive();
+		drv.ReadReceived(0, buf, size);
+		delayMicroseconds(workUs);
+		drv.EndReceive();
+
+		auto blocking = Nanos() - t;
+
+		if (len != size + 4 || memcmp(buf, frame, size) != 0) res = 1;
+
+		emuDma.Inject(frame, size);
+
+		t = Nanos();
+
+		len = drvDma.BeginReceive();
+		drvDma.StartReadReceived(0, buf, size);
+		delayMicroseconds(workUs);
+		if (!drvDma.WaitTransfer()) res = 1;
+		drvDma.EndReceive();
+
+		auto async = Nanos() - t;
+
+		if (len != size + 4 || memcmp(buf, frame, size) != 0) res = 1;
+
+		printf("rxa %5u bytes : %3u us work %8.1f us blocking %8.1f us async\n",
+			size, workUs, blocking / 1000.0, async / 1000.0);
+	}
+
+	// aborted block : reported by WaitTransfer, the frame read again
+	{
+		auto size = sizes[1];
+
+		emuDma.Inject(frame, size);
+
+		auto len = drvDma.BeginReceive();
+		dma.FailNextBlock();
+		drvDma.StartReadReceived(0, buf, size);
+		if (drvDma.WaitTransfer()) res = 1;
+
+		auto t = Nanos();
+
+		drvDma.ReadReceived(0, buf, size);
+		drvDma.EndReceive();
+
+		if (len != size + 4 || memcmp(buf, frame, size) != 0) res = 1;
+
+		printf("rxa %5u bytes : aborted, read again in %8.1f us\n", size, (Nanos() - t) / 1000.0);
+	}
+
+	return res;
+}
@@ -0,0 +1,988 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Emulator.h"
+#include "Host.h"
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			namespace Host
+			{
+
+				namespace
+				{
+
+					// register map ( tbl. #3-2 ) kept independent from Registers.h
+					// so that the model does not inherit driver assumptions
+
+					// bank0
+					const byte ERDPTL = 0x00;
+					const byte EWRPTL = 0x02;
+					const byte ETXSTL = 0x04;
+					const byte ETXNDL = 0x06;
+					const byte ERXSTL = 0x08;
+					const byte ERXSTH = 0x09;
+					const byte ERXNDL = 0x0A;
+					const byte ERXRDPTL = 0x0C;
+					const byte ERXRDPTH = 0x0D;
+					const byte ERXWRPTL = 0x0E;
+					const byte ERXWRPTH = 0x0F;
+					const byte EDMASTL = 0x10;
+					const byte EDMANDL = 0x12;
+					const byte EDMADSTL = 0x14;
+					const byte EDMACSL = 0x16;
+					const byte EDMACSH = 0x17;
+
+					// bank1
+					const byte EHT0 = 0x00;
+					const byte EPMM0 = 0x08;
+					const byte EPMCSL = 0x10;
+					const byte EPMCSH = 0x11;
+					const byte EPMOL = 0x14;
+					const byte ERXFCON = 0x18;
+					const byte EPKTCNT = 0x19;
+
+					// bank2
+					const byte MACON1 = 0x00;
+					const byte MACON3 = 0x02;
+					const byte MACLCON1 = 0x08;
+					const byte MACLCON2 = 0x09;
+					const byte MAMXFLL = 0x0A;
+					const byte MICMD = 0x12;
+					const byte MIREGADR = 0x14;
+					const byte MIWRL = 0x16;
+					const byte MIWRH = 0x17;
+					const byte MIRDL = 0x18;
+					const byte MIRDH = 0x19;
+
+					// bank3
+					const byte MAADR5 = 0x00;
+					const byte MAADR6 = 0x01;
+					const byte MAADR3 = 0x02;
+					const byte MAADR4 = 0x03;
+					const byte MAADR1 = 0x04;
+					const byte MAADR2 = 0x05;
+					const byte MISTAT = 0x0A;
+					const byte EREVID = 0x12;
+					const byte ECOCON = 0x15;
+					const byte EPAUSL = 0x18;
+
+					// common
+					const byte EIE = 0x1B;
+					const byte EIR = 0x1C;
+					const byte ESTAT = 0x1D;
+					const byte ECON2 = 0x1E;
+					const byte ECON1 = 0x1F;
+
+					// phy
+					const byte PHCON1 = 0x00;
+					const byte PHSTAT1 = 0x01;
+					const byte PHID1 = 0x02;
+					const byte PHID2 = 0x03;
+					const byte PHCON2 = 0x10;
+					const byte PHSTAT2 = 0x11;
+					const byte PHIE = 0x12;
+					const byte PHIR = 0x13;
+					const byte PHLCON = 0x14;
+
+					// #4.1 opcodes ( upper 3 bits )
+					const byte OP_RCR = 0x00;
+					const byte OP_RBM = 0x20;
+					const byte OP_WCR = 0x40;
+					const byte OP_WBM = 0x60;
+					const byte OP_BFS = 0x80;
+					const byte OP_BFC = 0xA0;
+
+					// EIE/EIR interrupt sources
+					const byte INT_SOURCES = 0x7B;
+
+					// MII operation time ( #3.3.1 10.24 us )
+					const uint32_t MII_BUSY_NS = 10240;
+
+					// 10Mbps wire byte time
+					const uint32_t WIRE_BYTE_NS = 800;
+
+					// DMA byte time ( 2 Tcy at 25 MHz )
+					const uint32_t DMA_BYTE_NS = 80;
+
+				}
+
+				uint32_t Crc32(const byte *data, uint16_t len)
+				{
+					uint32_t crc = 0xFFFFFFFF;
+					while (len--)
+					{
+						crc ^= *data++;
+						for (byte i = 0; i < 8; ++i)
+							crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+					}
+					return ~crc;
+				}
+
+				// #8.3 - hash table pointer ( crc bits 28:23 of the destination address )
+				static byte HashIndex(const byte *dst)
+				{
+					uint32_t crc = 0xFFFFFFFF;
+					for (byte i = 0; i < 6; ++i)
+					{
+						byte b = dst[i];
+						for (byte j = 0; j < 8; ++j)
+						{
+							crc = (crc << 1) ^ ((((crc >> 31) ^ b) & 1) ? 0x04C11DB7 : 0);
+							b >>= 1;
+						}
+					}
+					return (crc >> 23) & 0x3F;
+				}
+
+				Emulator::Emulator()
+				{
+					PowerOn();
+				}
+
+				byte& Emulator::Reg(byte bank, byte addr)
+				{
+					if (addr >= EIE) return commonRegs[addr - EIE];
+					return bankRegs[bank][addr];
+				}
+
+				byte Emulator::Reg(byte bank, byte addr) const
+				{
+					if (addr >= EIE) return commonRegs[addr - EIE];
+					return bankRegs[bank][addr];
+				}
+
+				uint16_t Emulator::Reg16(byte bank, byte addrL) const
+				{
+					return (uint16_t)Reg(bank, addrL) | ((uint16_t)Reg(bank, addrL + 1) << 8);
+				}
+
+				void Emulator::SetReg16(byte bank, byte addrL, uint16_t v)
+				{
+					Reg(bank, addrL) = lowByte(v);
+					Reg(bank, addrL + 1) = highByte(v);
+				}
+
+				byte Emulator::CurrentBank() const
+				{
+					return commonRegs[ECON1 - EIE] & B11;
+				}
+
+				// #4.2.1 - MAC and MII registers shift out a dummy byte first
+				bool Emulator::IsMacMii(byte bank, byte addr) const
+				{
+					if (addr >= EIE) return false;
+					if (bank == 2) return true;
+					if (bank == 3) return addr <= MAADR2 || addr == MISTAT;
+					return false;
+				}
+
+				void Emulator::PowerOn()
+				{
+					memset(sram, 0, sizeof(sram));
+
+					memset(phyRegs, 0, sizeof(phyRegs));
+					phyRegs[PHCON1] = 0x0000;
+					phyRegs[PHSTAT1] = 0x1800; // PFDPX, PHDPX
+					phyRegs[PHID1] = 0x0083;
+					phyRegs[PHID2] = 0x1400;
+					phyRegs[PHLCON] = 0x3422;
+
+					linkUp = true;
+
+					transmitted.clear();
+					txFails = 0;
+					txFailLateCollision = false;
+
+					SystemReset();
+
+					SetLink(true);
+					phyRegs[PHIR] = 0;
+
+					ClearCounters();
+				}
+
+				// tbl. #3-2 reset values
+				void Emulator::SystemReset()
+				{
+					memset(bankRegs, 0, sizeof(bankRegs));
+					memset(commonRegs, 0, sizeof(commonRegs));
+
+					SetReg16(0, ERDPTL, 0x05FA);
+					SetReg16(0, ERXSTL, 0x05FA);
+					SetReg16(0, ERXNDL, 0x1FFF);
+					SetReg16(0, ERXRDPTL, 0x05FA);
+					erxrdptlLatch = 0xFA;
+
+					Reg(1, ERXFCON) = 0xA1;
+
+					Reg(2, MACLCON1) = 0x0F;
+					Reg(2, MACLCON2) = 0x37;
+					SetReg16(2, MAMXFLL, 0x0600);
+
+					Reg(3, EREVID) = 0x06;
+					Reg(3, ECOCON) = 0x04;
+					SetReg16(3, EPAUSL, 0x1000);
+
+					Reg(0, ESTAT) = 0x01; // CLKRDY
+					Reg(0, ECON2) = 0x80; // AUTOINC
+
+					selected = false;
+					transferIndex = 0;
+
+					txPending = false;
+					dmaPending = false;
+					miiBusyUntil = 0;
+				}
+
+				//----------------------------------------------------------
+				// SPI side
+				//----------------------------------------------------------
+
+				void Emulator::Select()
+				{
+					Service();
+
+					selected = true;
+					transferIndex = 0;
+					++counters.transactions;
+				}
+
+				void Emulator::Deselect()
+				{
+					selected = false;
+				}
+
+				byte Emulator::Transfer(byte mosi)
+				{
+					if (!selected) return 0xFF;
+
+					++counters.bytes;
+
+					if (transferIndex++ == 0)
+					{
+						opcode = mosi & 0xE0;
+						argument = mosi & 0x1F;
+						++counters.opcodes[mosi >> 5];
+
+						if (mosi == 0xFF) SystemReset();
+
+						return 0;
+					}
+
+					switch (opcode)
+					{
+					case OP_RCR:
+					{
+						if (transferIndex == 2 && IsMacMii(CurrentBank(), argument)) return 0; // dummy
+
+						return ReadRegister(argument);
+					}
+
+					case OP_RBM:
+					{
+						if (argument != 0x1A) return 0;
+
+						auto ptr = Reg16(0, ERDPTL);
+						auto res = sram[ptr];
+						if (Reg(0, ECON2) & 0x80) SetReg16(0, ERDPTL, AdvanceRxPtr(ptr));
+
+						return res;
+					}
+
+					case OP_WBM:
+					{
+						if (argument != 0x1A) return 0;
+
+						auto ptr = Reg16(0, EWRPTL);
+						sram[ptr] = mosi;
+						if (Reg(0, ECON2) & 0x80) SetReg16(0, EWRPTL, (ptr + 1) & 0x1FFF);
+
+						return 0;
+					}
+
+					case OP_WCR:
+					case OP_BFS:
+					case OP_BFC:
+					{
+						if (transferIndex == 2) WriteRegister(argument, mosi, opcode);
+
+						return 0;
+					}
+					}
+
+					return 0;
+				}
+
+				byte Emulator::ReadRegister(byte addr)
+				{
+					auto bank = CurrentBank();
+
+					if (addr == EIR)
+					{
+						auto eir = Reg(bank, EIR) & ~0x40;
+						if (Reg(1, EPKTCNT) > 0) eir |= 0x40; // PKTIF
+						return eir;
+					}
+
+					if (addr == ESTAT)
+					{
+						auto estat = Reg(bank, ESTAT) | 0x01;
+						if (IntAsserted()) estat |= 0x80;
+						return estat;
+					}
+
+					if (bank == 3 && addr == MISTAT)
+					{
+						byte mistat = 0;
+						if (Host::Nanos() < miiBusyUntil) mistat |= 0x01; // BUSY
+						if (Reg(2, MICMD) & 0x02) mistat |= 0x02; // SCAN
+						return mistat;
+					}
+
+					if (bank == 2 && (addr == MIRDL || addr == MIRDH) && (Reg(2, MICMD) & 0x02))
+					{
+						// #3.3.3 - scan mode keeps MIRD updated
+						auto v = phyRegs[Reg(2, MIREGADR) & 0x1F];
+						return addr == MIRDL ? lowByte(v) : highByte(v);
+					}
+
+					return Reg(bank, addr);
+				}
+
+				void Emulator::WriteRegister(byte addr, byte value, byte op)
+				{
+					auto bank = CurrentBank();
+
+					// #4.2.5 - BFS/BFC are defined for ETH registers only
+					if (op != OP_WCR && IsMacMii(bank, addr)) ++counters.macBitFieldOps;
+
+					// read-only registers
+					if (addr < EIE)
+					{
+						if (bank == 0 && (addr == ERXWRPTL || addr == ERXWRPTH)) return;
+						if (bank == 1 && addr == EPKTCNT) return;
+						if (bank == 2 && (addr == MIRDL || addr == MIRDH)) return;
+						if (bank == 3 && (addr == MISTAT || addr == EREVID)) return;
+					}
+
+					auto& reg = Reg(bank, addr);
+					auto prev = reg;
+
+					byte next;
+					switch (op)
+					{
+					case OP_BFS: next = prev | value; break;
+					case OP_BFC: next = prev & ~value; break;
+					default: next = value; break;
+					}
+
+					if (addr == EIR) next = (next & ~0x50) | (prev & 0x50); // PKTIF, LINKIF read-only
+					else if (addr == ESTAT)
+					{
+						// BUFER, LATECOL, TXABRT can only be cleared
+						next = prev & (next | ~0x52);
+					}
+					// tbl. #3-2 - 13 bit buffer pointers : 5 bits high bytes
+					else if (bank == 0 && addr < EDMACSL && (addr & 1)) next &= 0x1F;
+
+					reg = next;
+
+					OnRegisterWritten(bank, addr, prev);
+				}
+
+				void Emulator::OnRegisterWritten(byte bank, byte addr, byte prev)
+				{
+					if (addr == ECON1)
+					{
+						auto econ1 = Reg(bank, ECON1);
+
+						// #11.3
+						if (econ1 & 0x80) txPending = false;
+
+						// #11.4
+						if (econ1 & 0x40) SetReg16(0, ERXWRPTL, Reg16(0, ERXSTL));
+
+						// #7.1.5
+						if ((econ1 & 0x08) && !(prev & 0x08) && !(econ1 & 0x80)) StartTransmit();
+						else if (!(econ1 & 0x08) && (prev & 0x08)) txPending = false; // aborted
+
+						// #13.1
+						if ((econ1 & 0x20) && !(prev & 0x20)) StartDma();
+						else if (!(econ1 & 0x20)) dmaPending = false;
+
+						return;
+					}
+
+					if (addr == ECON2)
+					{
+						// #7.2.4
+						auto& econ2 = Reg(bank, ECON2);
+						if (econ2 & 0x40)
+						{
+							auto& cnt = Reg(1, EPKTCNT);
+							if (cnt > 0) --cnt;
+							econ2 &= ~0x40;
+						}
+						return;
+					}
+
+					if (addr >= EIE) return;
+
+					switch (bank)
+					{
+					case 0:
+					{
+						if (addr == ERXSTL || addr == ERXSTH)
+							SetReg16(0, ERXWRPTL, Reg16(0, ERXSTL));
+						else if (addr == ERXRDPTL)
+						{
+							// #6.1 - low byte takes effect when the high byte is written
+							erxrdptlLatch = Reg(0, ERXRDPTL);
+							Reg(0, ERXRDPTL) = prev;
+						}
+						else if (addr == ERXRDPTH)
+							Reg(0, ERXRDPTL) = erxrdptlLatch;
+					}
+					break;
+
+					case 2:
+					{
+						auto now = Host::Nanos();
+
+						if (addr == MICMD)
+						{
+							auto micmd = Reg(2, MICMD);
+
+							// #3.3.1
+							if ((micmd & 0x01) && !(prev & 0x01))
+							{
+								if (now < miiBusyUntil) ++counters.miiBusyOps;
+
+								auto praddr = Reg(2, MIREGADR) & 0x1F;
+								auto v = phyRegs[praddr];
+								SetReg16(2, MIRDL, v);
+
+								if (praddr == PHIR)
+								{
+									// #12.1.5 - reading PHIR clears the link interrupt
+									phyRegs[PHIR] &= ~(0x10 | 0x04);
+									UpdateLinkInterrupt();
+								}
+								else if (praddr == PHSTAT1)
+								{
+									if (linkUp) phyRegs[PHSTAT1] |= 0x04;
+								}
+
+								miiBusyUntil = now + MII_BUSY_NS;
+							}
+						}
+						else if (addr == MIWRH)
+						{
+							// #3.3.2
+							auto praddr = Reg(2, MIREGADR) & 0x1F;
+							auto v = Reg16(2, MIWRL);
+
+							if (now < miiBusyUntil) ++counters.miiBusyOps;
+
+							if (praddr != PHSTAT1 && praddr != PHSTAT2 && praddr != PHIR &&
+								praddr != PHID1 && praddr != PHID2)
+								phyRegs[praddr] = v;
+
+							if (praddr == PHIE) UpdateLinkInterrupt();
+
+							miiBusyUntil = now + MII_BUSY_NS;
+						}
+					}
+					break;
+					}
+				}
+
+				// #4.2.2 - ERDPT and the rx write pointer wrap from ERXND to ERXST
+				// and from 0x1FFF to 0
+				uint16_t Emulator::AdvanceRxPtr(uint16_t ptr) const
+				{
+					if (ptr == Reg16(0, ERXNDL)) return Reg16(0, ERXSTL);
+					return (ptr + 1) & 0x1FFF;
+				}
+
+				//----------------------------------------------------------
+				// receive
+				//----------------------------------------------------------
+
+				bool Emulator::PatternMatch(const byte *frame, uint16_t len) const
+				{
+					// #8.2
+					auto off = Reg16(1, EPMOL);
+
+					if (off + 64 > len) return false;
+
+					uint32_t sum = 0;
+					uint16_t idx = 0;
+					for (byte i = 0; i < 64; ++i)
+					{
+						if (!(Reg(1, EPMM0 + i / 8) & (1 << (i % 8)))) continue;
+
+						byte b = frame[off + i];
+						sum += (idx % 2 == 0) ? ((uint16_t)b << 8) : b;
+						++idx;
+					}
+					while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+
+					uint16_t chksum = ~sum;
+
+					return chksum == Reg16(1, EPMCSL);
+				}
+
+				bool Emulator::HashMatch(const byte *frame) const
+				{
+					auto idx = HashIndex(frame);
+
+					return (Reg(1, EHT0 + idx / 8) & (1 << (idx % 8))) != 0;
+				}
+
+				// #8 - receive filters
+				bool Emulator::Filter(const byte *frame, uint16_t len, bool crcOk)
+				{
+					auto erxfcon = Reg(1, ERXFCON);
+
+					if ((erxfcon & 0x20) && !crcOk) return false;
+
+					auto enabled = erxfcon & B10011111;
+					if (enabled == 0) return true; // promiscuous
+
+					bool broadcast = true;
+					for (byte i = 0; i < 6; ++i) if (frame[i] != 0xFF) broadcast = false;
+
+					bool unicast =
+						frame[0] == Reg(3, MAADR1) && frame[1] == Reg(3, MAADR2) &&
+						frame[2] == Reg(3, MAADR3) && frame[3] == Reg(3, MAADR4) &&
+						frame[4] == Reg(3, MAADR5) && frame[5] == Reg(3, MAADR6);
+
+					bool results[8] = { false };
+					results[7] = unicast;
+					results[4] = PatternMatch(frame, len);
+					results[3] = false; // magic packet not modelled
+					results[2] = HashMatch(frame);
+					results[1] = (frame[0] & 1) != 0;
+					results[0] = broadcast;
+
+					bool andMode = (erxfcon & 0x40) != 0;
+
+					for (byte i = 0; i < 8; ++i)
+					{
+						if (!(enabled & (1 << i))) continue;
+
+						if (andMode && !results[i]) return false;
+						if (!andMode && results[i]) return true;
+					}
+
+					return andMode;
+				}
+
+				bool Emulator::Inject(const byte *frame, uint16_t len, bool crcOk)
+				{
+					Service();
+
+					bool accepted = false;
+
+					// frame as seen by the MAC ( FCS included )
+					std::vector<byte> wire(frame, frame + len);
+					auto fcs = Crc32(frame, len);
+					if (!crcOk) fcs = ~fcs;
+					for (byte i = 0; i < 4; ++i) wire.push_back((fcs >> (8 * i)) & 0xFF);
+
+					uint16_t frameLen = wire.size();
+
+					if (!linkUp || !(Reg(0, ECON1) & 0x04) || (Reg(0, ECON1) & 0x40) || len < 14)
+						++counters.rxDropped;
+					else if (!Filter(wire.data(), frameLen, crcOk))
+					{
+						++counters.rxFiltered;
+						++counters.rxDropped;
+					}
+					else
+					{
+						auto rxst = Reg16(0, ERXSTL);
+						auto rxnd = Reg16(0, ERXNDL);
+						uint16_t size = rxnd - rxst + 1;
+						auto wrpt = Reg16(0, ERXWRPTL);
+						auto rdpt = Reg16(0, ERXRDPTL);
+
+						uint16_t free = (rdpt >= wrpt) ? (rdpt - wrpt) : (size - (wrpt - rdpt));
+
+						uint16_t needed = 6 + frameLen;
+						if (needed % 2 != 0) ++needed; // #7.2.2 next packet starts even
+
+						if (needed > free || Reg(1, EPKTCNT) == 0xFF)
+						{
+							// #12.1.2
+							Reg(0, EIR) |= 0x01; // RXERIF
+							++counters.rxDropped;
+						}
+						else
+						{
+							uint16_t next = wrpt;
+							for (uint16_t i = 0; i < needed; ++i) next = AdvanceRxPtr(next);
+
+							bool broadcast = true;
+							for (byte i = 0; i < 6; ++i) if (frame[i] != 0xFF) broadcast = false;
+
+							uint16_t typeLen = ((uint16_t)frame[12] << 8) | frame[13];
+
+							// #7-3
+							byte hdr[6];
+							hdr[0] = lowByte(next);
+							hdr[1] = highByte(next);
+							hdr[2] = lowByte(frameLen);
+							hdr[3] = highByte(frameLen);
+							hdr[4] = 0;
+							if (!crcOk) hdr[4] |= (1 << 4); // crc error
+							if (typeLen <= 1500 && typeLen != len - 14) hdr[4] |= (1 << 5); // length check error
+							if (typeLen > 1500) hdr[4] |= (1 << 6); // length out of range ( type field )
+							if (crcOk) hdr[4] |= (1 << 7); // received ok
+							hdr[5] = 0;
+							if ((frame[0] & 1) && !broadcast) hdr[5] |= (1 << 0);
+							if (broadcast) hdr[5] |= (1 << 1);
+							if (typeLen == 0x8808) hdr[5] |= (1 << 3);
+							if (typeLen == 0x8100) hdr[5] |= (1 << 6);
+
+							auto ptr = wrpt;
+							for (byte i = 0; i < 6; ++i) { sram[ptr] = hdr[i]; ptr = AdvanceRxPtr(ptr); }
+							for (uint16_t i = 0; i < frameLen; ++i) { sram[ptr] = wire[i]; ptr = AdvanceRxPtr(ptr); }
+
+							SetReg16(0, ERXWRPTL, next);
+							++Reg(1, EPKTCNT);
+
+							++counters.rxFrames;
+							accepted = true;
+						}
+					}
+
+					Host::PollInt();
+
+					return accepted;
+				}
+
+				//----------------------------------------------------------
+				// transmit
+				//----------------------------------------------------------
+
+				// #7.1
+				void Emulator::StartTransmit()
+				{
+					auto start = Reg16(0, ETXSTL);
+					auto end = Reg16(0, ETXNDL);
+
+					uint16_t len = end >= start ? end - start : 0;
+
+					auto control = sram[start];
+					auto macon3 = Reg(2, MACON3);
+
+					bool crc = (control & 0x01) ? (control & 0x02) != 0 : (macon3 & 0x10) != 0;
+					bool pad = (control & 0x01) ? (control & 0x04) != 0 : (macon3 & 0xE0) != 0;
+
+					uint32_t wireLen = len;
+					if (pad && wireLen < 60) wireLen = 60;
+					if (crc) wireLen += 4;
+
+					Reg(0, ESTAT) &= ~(0x02 | 0x10); // TXABRT, LATECOL
+
+					txPending = true;
+					txDoneAt = Host::Nanos() + (wireLen + 8 + 12) * WIRE_BYTE_NS;
+				}
+
+				void Emulator::CompleteTransmit()
+				{
+					txPending = false;
+
+					auto start = Reg16(0, ETXSTL);
+					auto end = Reg16(0, ETXNDL);
+					uint16_t len = end >= start ? end - start : 0;
+
+					std::vector<byte> frame(sram + ((start + 1) & 0x1FFF), sram + ((start + 1) & 0x1FFF) + len);
+
+					bool broadcast = len >= 6;
+					for (byte i = 0; i < 6 && i < len; ++i) if (frame[i] != 0xFF) broadcast = false;
+					bool multicast = len >= 6 && (frame[0] & 1) && !broadcast;
+
+					uint16_t count = len < 60 ? 64 : len + 4;
+
+					// #7-1 transmit status vector
+					byte tsv[7];
+					tsv[0] = lowByte(count);
+					tsv[1] = highByte(count);
+					tsv[2] = 0;
+					tsv[3] = 0;
+					if (multicast) tsv[3] |= (1 << 0);
+					if (broadcast) tsv[3] |= (1 << 1);
+					uint16_t onWire = count;
+					tsv[4] = lowByte(onWire);
+					tsv[5] = highByte(onWire);
+					tsv[6] = 0;
+
+					if (txFails > 0)
+					{
+						tsv[2] |= 0x0F; // collision count
+						if (txFailLateCollision) tsv[3] |= (1 << 5);
+						else tsv[3] |= (1 << 4);
+
+						Reg(0, ESTAT) |= 0x02 | (txFailLateCollision ? 0x10 : 0);
+						Reg(0, EIR) |= 0x02 | 0x08; // TXERIF, TXIF
+
+						--txFails;
+					}
+					else
+					{
+						tsv[2] |= (1 << 7); // done
+						Reg(0, EIR) |= 0x08; // TXIF
+
+						transmitted.push_back(frame);
+						++counters.txFrames;
+					}
+
+					for (byte i = 0; i < 7; ++i) sram[(end + 1 + i) & 0x1FFF] = tsv[i];
+
+					Reg(0, ECON1) &= ~0x08; // TXRTS
+				}
+
+				//----------------------------------------------------------
+				// DMA
+				//----------------------------------------------------------
+
+				// #13
+				void Emulator::StartDma()
+				{
+					auto start = Reg16(0, EDMASTL);
+					auto end = Reg16(0, EDMANDL);
+
+					uint32_t count = 1;
+					auto ptr = start;
+					while (ptr != end && count < 0x2000)
+					{
+						ptr = AdvanceRxPtr(ptr);
+						++count;
+					}
+
+					dmaPending = true;
+					dmaDoneAt = Host::Nanos() + count * DMA_BYTE_NS;
+				}
+
+				void Emulator::CompleteDma()
+				{
+					dmaPending = false;
+
+					auto start = Reg16(0, EDMASTL);
+					auto end = Reg16(0, EDMANDL);
+					auto rxst = Reg16(0, ERXSTL);
+					auto rxnd = Reg16(0, ERXNDL);
+
+					// #13.1 - source pointer wraps inside the rx buffer
+					auto nextSrc = [&](uint16_t p) -> uint16_t
+					{
+						if (p >= rxst && p <= rxnd) return p == rxnd ? rxst : p + 1;
+						return (p + 1) & 0x1FFF;
+					};
+
+					if (Reg(0, ECON1) & 0x10)
+					{
+						// #13.2 - checksum
+						uint32_t sum = 0;
+						uint16_t idx = 0;
+						auto p = start;
+						while (true)
+						{
+							sum += (idx % 2 == 0) ? ((uint16_t)sram[p] << 8) : sram[p];
+							++idx;
+							if (p == end || idx >= 0x2000) break;
+							p = nextSrc(p);
+						}
+						while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+
+						uint16_t chksum = ~sum;
+						Reg(0, EDMACSH) = highByte(chksum);
+						Reg(0, EDMACSL) = lowByte(chksum);
+					}
+					else
+					{
+						// #13.1 - copy
+						auto dst = Reg16(0, EDMADSTL);
+						auto p = start;
+						uint16_t idx = 0;
+						while (true)
+						{
+							sram[dst] = sram[p];
+							dst = nextSrc(dst);
+							++idx;
+							if (p == end || idx >= 0x2000) break;
+							p = nextSrc(p);
+						}
+					}
+
+					Reg(0, ECON1) &= ~0x20; // DMAST
+					Reg(0, EIR) |= 0x20; // DMAIF
+				}
+
+				//----------------------------------------------------------
+				// link
+				//----------------------------------------------------------
+
+				void Emulator::UpdateLinkInterrupt()
+				{
+					// #12.1.5
+					auto phie = phyRegs[PHIE];
+
+					if ((phyRegs[PHIR] & 0x10) && (phie & 0x02) && (phie & 0x10))
+					{
+						phyRegs[PHIR] |= 0x04; // PGIF
+						Reg(0, EIR) |= 0x10; // LINKIF
+					}
+					else
+					{
+						phyRegs[PHIR] &= ~0x04;
+						Reg(0, EIR) &= ~0x10;
+					}
+				}
+
+				void Emulator::SetLink(bool up)
+				{
+					bool changed = up != linkUp;
+
+					linkUp = up;
+
+					if (up)
+						phyRegs[PHSTAT2] |= (1 << 10);
+					else
+					{
+						phyRegs[PHSTAT2] &= ~(1 << 10);
+						phyRegs[PHSTAT1] &= ~0x04; // LLSTAT latches low
+					}
+
+					if (changed)
+					{
+						phyRegs[PHIR] |= 0x10; // PLNKIF
+						UpdateLinkInterrupt();
+						Host::PollInt();
+					}
+				}
+
+				bool Emulator::Link() const { return linkUp; }
+
+				//----------------------------------------------------------
+
+				void Emulator::Service()
+				{
+					auto now = Host::Nanos();
+
+					if (txPending && now >= txDoneAt) CompleteTransmit();
+					if (dmaPending && now >= dmaDoneAt) CompleteDma();
+				}
+
+				bool Emulator::IntAsserted() const
+				{
+					auto eie = Reg(0, EIE);
+					if (!(eie & 0x80)) return false;
+
+					auto eir = Reg(0, EIR);
+					if (Reg(1, EPKTCNT) > 0) eir |= 0x40;
+
+					return (eir & eie & INT_SOURCES) != 0;
+				}
+
+				size_t Emulator::TransmittedCount() const
+				{
+					return transmitted.size();
+				}
+
+				bool Emulator::PopTransmitted(std::vector<byte>& frame)
+				{
+					Service();
+
+					if (transmitted.empty()) return false;
+
+					frame = transmitted.front();
+					transmitted.pop_front();
+
+					return true;
+				}
+
+				void Emulator::FailNextTransmit(bool lateCollision, byte count)
+				{
+					txFails = count;
+					txFailLateCollision = lateCollision;
+				}
+
+				byte Emulator::Peek(byte craddress) const
+				{
+					return Reg((craddress >> 5) & B11, craddress & B11111);
+				}
+
+				uint16_t Emulator::PeekPhy(byte praddress) const
+				{
+					return phyRegs[praddress & 0x1F];
+				}
+
+				byte Emulator::PeekSram(uint16_t addr) const
+				{
+					return sram[addr & 0x1FFF];
+				}
+
+				void Emulator::PokeSram(uint16_t addr, const byte *data, uint16_t len)
+				{
+					while (len--) sram[addr++ & 0x1FFF] = *data++;
+				}
+
+				byte Emulator::PacketCount() const
+				{
+					return Reg(1, EPKTCNT);
+				}
+
+				const Emulator::Counters& Emulator::GetCounters() const
+				{
+					return counters;
+				}
+
+				void Emulator::ClearCounters()
+				{
+					memset(&counters, 0, sizeof(counters));
+				}
+
+			}
+
+		}
+
+	}
+
+}
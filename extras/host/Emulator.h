@@ -0,0 +1,211 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#ifndef _SEARCHATHING_ARDUINO_ENC28J60_HOST_EMULATOR_H
+#define _SEARCHATHING_ARDUINO_ENC28J60_HOST_EMULATOR_H
+
+#include "arduino.h"
+
+#include <vector>
+#include <deque>
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			namespace Host
+			{
+
+				// Software model of the ENC28J60 as seen from the SPI bus and
+				// from the wire. Covers the #4.1 instruction set, banked
+				// control registers, MAC/MII registers ( with dummy byte ),
+				// PHY registers through MII management, the 8K buffer memory,
+				// the rx ring with EPKTCNT semantics, receive filters, the
+				// transmit engine with status vector and the DMA engine.
+				//
+				// Timings ( tx wire time, MII busy, DMA ) follow the virtual
+				// clock of Host.h so that polling loops terminate.
+				class Emulator
+				{
+
+				public:
+					// SPI and wire activity counters
+					struct Counters
+					{
+						// chip-select cycles
+						uint32_t transactions;
+						// bytes clocked on the bus ( opcode included )
+						uint32_t bytes;
+						// transactions per opcode ( index = opcode >> 5 )
+						uint32_t opcodes[8];
+						// BFS/BFC issued on MAC/MII registers ( #4.2.5 undefined on silicon,
+						// modelled as if applied )
+						uint32_t macBitFieldOps;
+						// MII read or write started while MISTAT.BUSY ( #3.3.2 )
+						uint32_t miiBusyOps;
+						// frames stored into the rx ring
+						uint32_t rxFrames;
+						// frames not stored ( rx disabled, filtered out, ring full )
+						uint32_t rxDropped;
+						// frames rejected by the receive filters
+						uint32_t rxFiltered;
+						// frames sent on the wire
+						uint32_t txFrames;
+					};
+
+				private:
+					byte bankRegs[4][0x1B];
+					byte commonRegs[5]; // EIE, EIR, ESTAT, ECON2, ECON1
+					uint16_t phyRegs[0x20];
+					byte sram[0x2000];
+
+					// ERXRDPTL is latched until ERXRDPTH is written
+					byte erxrdptlLatch;
+
+					bool selected;
+					byte opcode;
+					byte argument;
+					uint16_t transferIndex;
+
+					bool linkUp;
+
+					bool txPending;
+					uint64_t txDoneAt;
+					byte txFails;
+					bool txFailLateCollision;
+
+					bool dmaPending;
+					uint64_t dmaDoneAt;
+
+					uint64_t miiBusyUntil;
+
+					std::deque<std::vector<byte>> transmitted;
+
+					Counters counters;
+
+					byte& Reg(byte bank, byte addr);
+					byte Reg(byte bank, byte addr) const;
+					uint16_t Reg16(byte bank, byte addrL) const;
+					void SetReg16(byte bank, byte addrL, uint16_t v);
+
+					byte CurrentBank() const;
+					bool IsMacMii(byte bank, byte addr) const;
+
+					byte ReadRegister(byte addr);
+					void WriteRegister(byte addr, byte value, byte op);
+					void OnRegisterWritten(byte bank, byte addr, byte prev);
+
+					uint16_t AdvanceRxPtr(uint16_t ptr) const;
+
+					bool Filter(const byte *frame, uint16_t len, bool crcOk);
+					bool PatternMatch(const byte *frame, uint16_t len) const;
+					bool HashMatch(const byte *frame) const;
+
+					void StartTransmit();
+					void CompleteTransmit();
+					void StartDma();
+					void CompleteDma();
+					void UpdateLinkInterrupt();
+
+				public:
+					Emulator();
+
+					// power-on reset ( buffer memory is cleared, phy reset )
+					void PowerOn();
+
+					// system reset as issued by the SRC instruction
+					void SystemReset();
+
+					//----------------------------------------------------------
+					// SPI side ( driven by the host SPI stand-in )
+					//----------------------------------------------------------
+
+					void Select();
+					void Deselect();
+					byte Transfer(byte mosi);
+
+					//----------------------------------------------------------
+					// wire side
+					//----------------------------------------------------------
+
+					// deliver a frame ( without FCS ) from the wire;
+					// returns false if the frame was not stored into the rx ring
+					bool Inject(const byte *frame, uint16_t len, bool crcOk = true);
+
+					// number of frames sent by the chip not yet collected
+					size_t TransmittedCount() const;
+
+					// collect the oldest frame sent by the chip ( without FCS )
+					bool PopTransmitted(std::vector<byte>& frame);
+
+					// next count transmissions will abort ( late collision or excessive
+					// collisions )
+					void FailNextTransmit(bool lateCollision, byte count = 1);
+
+					void SetLink(bool up);
+					bool Link() const;
+
+					// complete pending transmit and DMA operations whose time elapsed
+					void Service();
+
+					// INT pin asserted ( active low on the real chip )
+					bool IntAsserted() const;
+
+					//----------------------------------------------------------
+					// inspection
+					//----------------------------------------------------------
+
+					// read a register by Compact Register Address without side effects
+					byte Peek(byte craddress) const;
+					uint16_t PeekPhy(byte praddress) const;
+					byte PeekSram(uint16_t addr) const;
+					void PokeSram(uint16_t addr, const byte *data, uint16_t len);
+					byte PacketCount() const;
+
+					const Counters& GetCounters() const;
+					void ClearCounters();
+
+				};
+
+				// Ethernet FCS ( IEEE 802.3 crc32, reflected )
+				uint32_t Crc32(const byte *data, uint16_t len);
+
+			}
+
+		}
+
+	}
+
+}
+
+#endif
@@ -0,0 +1,161 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "EmulatorDmaSpi.h"
+#include "Host.h"
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			namespace Host
+			{
+
+				byte EmulatorDmaSpi::busSelected = 0;
+				uint32_t EmulatorDmaSpi::busConflicts = 0;
+
+				EmulatorDmaSpi::EmulatorDmaSpi(Emulator *_emu, uint32_t clock)
+				{
+					emu = _emu;
+					byteNanos = (uint32_t)(8000000000ULL / clock);
+				}
+
+				void EmulatorDmaSpi::Begin()
+				{
+				}
+
+				void EmulatorDmaSpi::Select()
+				{
+					if (busSelected++ > 0) ++busConflicts;
+
+					emu->Select();
+				}
+
+				void EmulatorDmaSpi::Deselect()
+				{
+					--busSelected;
+
+					emu->Deselect();
+
+					PollInt();
+				}
+
+				byte EmulatorDmaSpi::Transfer(byte data)
+				{
+					Advance(byteNanos);
+
+					return emu->Transfer(data);
+				}
+
+				void EmulatorDmaSpi::StartReadBlock(byte *data, uint16_t _len, SpiDoneCallback _done, void *ctx)
+				{
+					rx = data;
+					tx = NULL;
+					len = _len;
+					done = _done;
+					doneCtx = ctx;
+					doneAt = Nanos() + (uint64_t)_len * byteNanos;
+					pending = true;
+
+					++blocks;
+				}
+
+				void EmulatorDmaSpi::StartWriteBlock(const byte *data, uint16_t _len, SpiDoneCallback _done, void *ctx)
+				{
+					rx = NULL;
+					tx = data;
+					len = _len;
+					done = _done;
+					doneCtx = ctx;
+					doneAt = Nanos() + (uint64_t)_len * byteNanos;
+					pending = true;
+
+					++blocks;
+				}
+
+				void EmulatorDmaSpi::Poll()
+				{
+					if (pending && Nanos() >= doneAt) Complete();
+				}
+
+				void EmulatorDmaSpi::Complete()
+				{
+					if (!pending) return;
+
+					pending = false;
+
+					if (failNext)
+					{
+						failNext = false;
+						done(doneCtx, false);
+						return;
+					}
+
+					// data sampled at completion : a caller touching tx before
+					// done would be caught
+					for (uint16_t i = 0; i < len; ++i)
+					{
+						auto res = emu->Transfer(tx != NULL ? tx[i] : 0);
+						if (rx != NULL) rx[i] = res;
+					}
+
+					done(doneCtx, true);
+				}
+
+				void EmulatorDmaSpi::FailNextBlock()
+				{
+					failNext = true;
+				}
+
+				bool EmulatorDmaSpi::Pending() const
+				{
+					return pending;
+				}
+
+				uint32_t EmulatorDmaSpi::Blocks() const
+				{
+					return blocks;
+				}
+
+				uint32_t EmulatorDmaSpi::BusConflicts()
+				{
+					return busConflicts;
+				}
+
+			}
+
+		}
+
+	}
+
+}
@@ -0,0 +1,108 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#ifndef _SEARCHATHING_ARDUINO_ENC28J60_HOST_EMULATORDMASPI_H
+#define _SEARCHATHING_ARDUINO_ENC28J60_HOST_EMULATORDMASPI_H
+
+#include "SpiTransport.h"
+#include "Emulator.h"
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			namespace Host
+			{
+
+				// simulated SPI DMA : a started block is moved into the emulator
+				// once the virtual clock has run for its len bytes, and its
+				// completion reported by Poll ( or Complete ), so that the time
+				// spent by the caller meanwhile overlaps the transfer
+				class EmulatorDmaSpi : public SpiTransport
+				{
+
+					Emulator *emu;
+					uint32_t byteNanos;
+
+					// started block
+					bool pending = false;
+					byte *rx;
+					const byte *tx;
+					uint16_t len;
+					uint64_t doneAt;
+					SpiDoneCallback done;
+					void *doneCtx;
+
+					bool failNext = false;
+					uint32_t blocks = 0;
+
+					// instances model transports sharing one bus
+					static byte busSelected;
+					static uint32_t busConflicts;
+
+				public:
+					EmulatorDmaSpi(Emulator *_emu, uint32_t clock = ETH_SPI_CLOCK);
+
+					void Begin();
+					void Select();
+					void Deselect();
+					byte Transfer(byte data);
+
+					void StartReadBlock(byte *data, uint16_t len, SpiDoneCallback done, void *ctx);
+					void StartWriteBlock(const byte *data, uint16_t len, SpiDoneCallback done, void *ctx);
+					void Poll();
+
+					// report the started block now regardless of the clock
+					void Complete();
+
+					// the next started block is aborted without moving data
+					void FailNextBlock();
+
+					bool Pending() const;
+					// blocks started since construction
+					uint32_t Blocks() const;
+
+					// selects issued while another instance held the bus
+					static uint32_t BusConflicts();
+
+				};
+
+			}
+
+		}
+
+	}
+
+}
+
+#endif
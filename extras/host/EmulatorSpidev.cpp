@@ -0,0 +1,191 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "EmulatorSpidev.h"
+#include "Host.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/spi/spidev.h>
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			namespace Host
+			{
+
+				// fd returned by SysOpen
+				const int EMULATOR_FD = 1000;
+
+				EmulatorSpidev::EmulatorSpidev(Emulator *_emu, uint32_t _clock) :
+					SpidevTransport("emulator", _clock)
+				{
+					emu = _emu;
+				}
+
+				EmulatorSpidev::~EmulatorSpidev()
+				{
+					End();
+				}
+
+				void EmulatorSpidev::FailNextMessage() { failNext = true; }
+
+				uint32_t EmulatorSpidev::Messages() const { return messages; }
+
+				int EmulatorSpidev::SysOpen(const char *path, int flags)
+				{
+					if (opened || (flags & O_ACCMODE) != O_RDWR)
+					{
+						errno = EBUSY;
+						return -1;
+					}
+
+					opened = true;
+
+					return EMULATOR_FD;
+				}
+
+				int EmulatorSpidev::SysIoctl(int fd, unsigned long request, void *arg)
+				{
+					if (!opened || fd != EMULATOR_FD)
+					{
+						errno = EBADF;
+						return -1;
+					}
+
+					if (request == SPI_IOC_WR_MODE)
+					{
+						// #4 - the controller only speaks mode 0,0
+						if (*(uint8_t *)arg != SPI_MODE_0) { errno = EINVAL; return -1; }
+						return 0;
+					}
+
+					if (request == SPI_IOC_WR_BITS_PER_WORD)
+					{
+						if (*(uint8_t *)arg != 8) { errno = EINVAL; return -1; }
+						return 0;
+					}
+
+					if (request == SPI_IOC_WR_MAX_SPEED_HZ)
+					{
+						// #16 : 20 MHz max
+						auto hz = *(uint32_t *)arg;
+						if (hz == 0) { errno = EINVAL; return -1; }
+						if (hz > 20000000) hz = 20000000;
+						byteNanos = (uint32_t)(8000000000ULL / hz);
+						return 0;
+					}
+
+					// SPI_IOC_MESSAGE(n) : n transfers, n encoded in the size
+					if (_IOC_TYPE(request) != SPI_IOC_MAGIC || _IOC_NR(request) != 0 ||
+						_IOC_DIR(request) != _IOC_WRITE || _IOC_SIZE(request) == 0 ||
+						_IOC_SIZE(request) % sizeof(spi_ioc_transfer) != 0)
+					{
+						errno = ENOTTY;
+						return -1;
+					}
+
+					if (failNext)
+					{
+						failNext = false;
+						errno = EIO;
+						return -1;
+					}
+
+					++messages;
+
+					auto tr = (const spi_ioc_transfer *)arg;
+					auto n = _IOC_SIZE(request) / sizeof(spi_ioc_transfer);
+					int total = 0;
+
+					for (unsigned t = 0; t < n; ++t)
+					{
+						auto tx = (const byte *)(uintptr_t)tr[t].tx_buf;
+						auto rx = (byte *)(uintptr_t)tr[t].rx_buf;
+
+						if (!selected)
+						{
+							emu->Select();
+							selected = true;
+						}
+
+						for (uint32_t i = 0; i < tr[t].len; ++i)
+						{
+							auto res = emu->Transfer(tx != NULL ? tx[i] : 0);
+							if (rx != NULL) rx[i] = res;
+						}
+
+						Advance(tr[t].len * byteNanos);
+						total += tr[t].len;
+
+						// cs_change : CS released between transfers, kept
+						// asserted after the last one
+						if ((tr[t].cs_change != 0) == (t + 1 < n))
+						{
+							emu->Deselect();
+							selected = false;
+
+							PollInt();
+						}
+					}
+
+					return total;
+				}
+
+				int EmulatorSpidev::SysClose(int fd)
+				{
+					if (!opened || fd != EMULATOR_FD)
+					{
+						errno = EBADF;
+						return -1;
+					}
+
+					if (selected)
+					{
+						emu->Deselect();
+						selected = false;
+					}
+
+					opened = false;
+
+					return 0;
+				}
+
+			}
+
+		}
+
+	}
+
+}
@@ -0,0 +1,85 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#ifndef _SEARCHATHING_ARDUINO_ENC28J60_HOST_EMULATORSPIDEV_H
+#define _SEARCHATHING_ARDUINO_ENC28J60_HOST_EMULATORSPIDEV_H
+
+#include "SpidevTransport.h"
+#include "Emulator.h"
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			namespace Host
+			{
+
+				// fake spidev device : the SpidevTransport system calls are
+				// decoded and SPI_IOC_MESSAGE transfers clocked into the
+				// emulator, CS following their cs_change flag
+				class EmulatorSpidev : public SpidevTransport
+				{
+
+					Emulator *emu;
+					uint32_t byteNanos = 0;
+					bool opened = false;
+					bool selected = false;
+					bool failNext = false;
+					uint32_t messages = 0;
+
+				protected:
+					int SysOpen(const char *path, int flags);
+					int SysIoctl(int fd, unsigned long request, void *arg);
+					int SysClose(int fd);
+
+				public:
+					EmulatorSpidev(Emulator *_emu, uint32_t _clock = ETH_SPI_CLOCK);
+					~EmulatorSpidev();
+
+					// next SPI_IOC_MESSAGE fails without reaching the emulator
+					void FailNextMessage();
+
+					// SPI_IOC_MESSAGE ioctls reaching the emulator
+					uint32_t Messages() const;
+
+				};
+
+			}
+
+		}
+
+	}
+
+}
+
+#endif
@@ -0,0 +1,76 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#ifndef _SEARCHATHING_ARDUINO_ENC28J60_HOST_HOST_H
+#define _SEARCHATHING_ARDUINO_ENC28J60_HOST_HOST_H
+
+#include "arduino.h"
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			namespace Host
+			{
+
+				class Emulator;
+
+				// connect the emulator chip-select to the given digital pin
+				// ( the SPI stand-in talks to the chip whose CS is LOW )
+				void Attach(uint8_t csPin, Emulator *emu);
+
+				// connect the emulator INT output to the given interrupt number
+				// ( a falling edge invokes the handler set by attachInterrupt )
+				void AttachInt(uint8_t interruptNum, Emulator *emu);
+
+				void Detach(Emulator *emu);
+
+				// check INT lines of attached emulators and dispatch the isr
+				// on falling edges ( called automatically after each SPI
+				// transaction and after frame injection )
+				void PollInt();
+
+				// virtual clock in nanoseconds
+				uint64_t Nanos();
+				void Advance(uint32_t ns);
+				void ResetClock();
+
+			}
+
+		}
+
+	}
+
+}
+
+#endif
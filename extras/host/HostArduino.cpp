@@ -0,0 +1,230 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include "arduino.h"
+#include "SPI.h"
+
+#include "Host.h"
+#include "Emulator.h"
+
+#include <vector>
+
+SPIClass SPI;
+
+namespace
+{
+
+	using SearchAThing::Arduino::Enc28j60::Host::Emulator;
+
+	struct CsBinding
+	{
+		uint8_t pin;
+		Emulator *emu;
+	};
+
+	struct IntBinding
+	{
+		uint8_t interruptNum;
+		Emulator *emu;
+		bool asserted;
+	};
+
+	std::vector<CsBinding> csBindings;
+	std::vector<IntBinding> intBindings;
+
+	uint8_t pinLevel[256];
+	void(*isrs[256])(void);
+
+	uint64_t nanos = 0;
+
+	// 8 bit per byte at the SPISettings clock ( #16 : 20 MHz max )
+	uint32_t byteNanos = 400;
+
+	bool inIsr = false;
+
+	struct PinInit
+	{
+		PinInit() { memset(pinLevel, HIGH, sizeof(pinLevel)); }
+	} pinInit;
+
+}
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			namespace Host
+			{
+
+				void Attach(uint8_t csPin, Emulator *emu)
+				{
+					csBindings.push_back({ csPin, emu });
+				}
+
+				void AttachInt(uint8_t interruptNum, Emulator *emu)
+				{
+					intBindings.push_back({ interruptNum, emu, emu->IntAsserted() });
+				}
+
+				void Detach(Emulator *emu)
+				{
+					for (auto it = csBindings.begin(); it != csBindings.end();)
+						it = it->emu == emu ? csBindings.erase(it) : it + 1;
+
+					for (auto it = intBindings.begin(); it != intBindings.end();)
+						it = it->emu == emu ? intBindings.erase(it) : it + 1;
+				}
+
+				void PollInt()
+				{
+					if (inIsr) return;
+
+					for (auto& b : intBindings)
+					{
+						b.emu->Service();
+
+						auto asserted = b.emu->IntAsserted();
+						if (asserted && !b.asserted && isrs[b.interruptNum])
+						{
+							inIsr = true;
+							isrs[b.interruptNum]();
+							inIsr = false;
+						}
+						b.asserted = asserted;
+					}
+				}
+
+				uint64_t Nanos() { return nanos; }
+
+				void Advance(uint32_t ns)
+				{
+					nanos += ns;
+					PollInt();
+				}
+
+				void ResetClock() { nanos = 0; }
+
+			}
+
+		}
+
+	}
+
+}
+
+using namespace SearchAThing::Arduino::Enc28j60;
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+	auto prev = pinLevel[pin];
+	pinLevel[pin] = val;
+
+	if (prev == val) return;
+
+	for (auto& b : csBindings)
+	{
+		if (b.pin != pin) continue;
+
+		if (val == LOW)
+			b.emu->Select();
+		else
+			b.emu->Deselect();
+	}
+
+	if (val == HIGH) Host::PollInt();
+}
+
+int digitalRead(uint8_t pin)
+{
+	return pinLevel[pin];
+}
+
+void attachInterrupt(uint8_t interruptNum, void(*userFunc)(void), int mode)
+{
+	isrs[interruptNum] = userFunc;
+}
+
+void detachInterrupt(uint8_t interruptNum)
+{
+	isrs[interruptNum] = NULL;
+}
+
+unsigned long millis() { return (unsigned long)(nanos / 1000000); }
+
+unsigned long micros() { return (unsigned long)(nanos / 1000); }
+
+void delay(unsigned long ms) { Host::Advance(ms * 1000000); }
+
+void delayMicroseconds(unsigned int us) { Host::Advance(us * 1000); }
+
+//--
+
+void SPIClass::begin() { }
+
+void SPIClass::end() { }
+
+void SPIClass::beginTransaction(SPISettings settings)
+{
+	auto clock = settings.clock > 20000000 ? 20000000 : settings.clock;
+	byteNanos = (uint32_t)(8000000000ULL / clock);
+}
+
+void SPIClass::endTransaction() { }
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+	nanos += byteNanos;
+
+	uint8_t res = 0xFF;
+	for (auto& b : csBindings)
+	{
+		if (pinLevel[b.pin] == LOW) res &= b.emu->Transfer(data);
+	}
+
+	return res;
+}
+
+uint16_t SPIClass::transfer16(uint16_t data)
+{
+	uint16_t hi = transfer(highByte(data));
+	return (hi << 8) | transfer(lowByte(data));
+}
+
+void SPIClass::transfer(void *buf, size_t count)
+{
+	auto p = (uint8_t *)buf;
+	while (count--)
+	{
+		*p = transfer(*p);
+		++p;
+	}
+}
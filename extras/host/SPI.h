@@ -0,0 +1,66 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Host stand-in for the Arduino SPI library: transfers are routed to the
+// Emulator attached to the chip-select pin currently driven LOW.
+
+#ifndef _SEARCHATHING_ARDUINO_ENC28J60_HOST_SPI_H
+#define _SEARCHATHING_ARDUINO_ENC28J60_HOST_SPI_H
+
+#include "arduino.h"
+
+#define SPI_MODE0		0x00
+#define SPI_MODE1		0x04
+#define SPI_MODE2		0x08
+#define SPI_MODE3		0x0C
+
+class SPISettings
+{
+
+public:
+	uint32_t clock;
+
+	SPISettings() : clock(4000000) { }
+	SPISettings(uint32_t _clock, uint8_t bitOrder, uint8_t dataMode) : clock(_clock) { }
+
+};
+
+class SPIClass
+{
+
+public:
+	void begin();
+	void end();
+
+	void beginTransaction(SPISettings settings);
+	void endTransaction();
+
+	uint8_t transfer(uint8_t data);
+	uint16_t transfer16(uint16_t data);
+	void transfer(void *buf, size_t count);
+
+};
+
+extern SPIClass SPI;
+
+#endif
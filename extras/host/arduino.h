@@ -0,0 +1,90 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Host (Linux) stand-in for the subset of the Arduino core used by the
+// library, so that Driver.cpp builds unchanged against the Emulator.
+// Time is virtual: delay() and SPI traffic advance the clock instead of
+// sleeping ( see Host.h ).
+
+#ifndef _SEARCHATHING_ARDUINO_ENC28J60_HOST_ARDUINO_H
+#define _SEARCHATHING_ARDUINO_ENC28J60_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "binary.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define HIGH			0x1
+#define LOW				0x0
+
+#define INPUT			0x0
+#define OUTPUT			0x1
+#define INPUT_PULLUP	0x2
+
+#define LSBFIRST		0
+#define MSBFIRST		1
+
+#define CHANGE			1
+#define FALLING			2
+#define RISING			3
+
+#define lowByte(w)		((uint8_t) ((w) & 0xff))
+#define highByte(w)		((uint8_t) ((w) >> 8))
+
+#define bitRead(value, bit)	(((value) >> (bit)) & 0x01)
+#define bit(b)				(1UL << (b))
+
+#define PROGMEM
+#define PSTR(s)				(s)
+#define pgm_read_byte(p)	(*(const uint8_t *)(p))
+#define pgm_read_word(p)	(*(const uint16_t *)(p))
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+// external interrupts of an Uno ( INT0, INT1 )
+#define NOT_AN_INTERRUPT			-1
+#define digitalPinToInterrupt(p)	((p) == 2 ? 0 : ((p) == 3 ? 1 : NOT_AN_INTERRUPT))
+
+#define noInterrupts()
+#define interrupts()
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+void attachInterrupt(uint8_t interruptNum, void(*userFunc)(void), int mode);
+void detachInterrupt(uint8_t interruptNum);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+#endif
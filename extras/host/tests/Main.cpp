@@ -0,0 +1,135 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+//===========================================================================
+// HOST TESTS : Driver features checked against the Emulator
+//===========================================================================
+// Runs every TEST linked in ( extras/host/tests/*.cpp ), each on a fresh
+// virtual clock, and prints the failed CHECKs. Exit code is non zero if
+// any CHECK failed.
+//---------------------------------------------------------------------------
+
+#include <vector>
+
+#include "Test.h"
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			namespace Host
+			{
+
+				struct TestEntry
+				{
+					const char *name;
+					TestFn fn;
+				};
+
+				// function local : registrations run during static init
+				static std::vector<TestEntry>& Tests()
+				{
+					static std::vector<TestEntry> tests;
+					return tests;
+				}
+
+				static int failures = 0;
+
+				TestRegistration::TestRegistration(const char *name, TestFn fn)
+				{
+					Tests().push_back({ name, fn });
+				}
+
+				void TestFail(const char *file, int line, const char *expr)
+				{
+					printf("  %s:%d: CHECK(%s) failed\n", file, line, expr);
+					++failures;
+				}
+
+				TestChip::TestChip(uint8_t csPin, int intNum)
+				{
+					Attach(csPin, &emu);
+					if (intNum >= 0) AttachInt(intNum, &emu);
+				}
+
+				TestChip::~TestChip()
+				{
+					Detach(&emu);
+				}
+
+				const byte TestMac[6] = { 0x00, 0x00, 0x6c, 0x00, 0x00, 0x01 };
+				const byte TestPeer[6] = { 0x00, 0x00, 0x6c, 0x00, 0x00, 0x09 };
+
+				byte TestBuf[MAX_FRAME_LENGTH];
+
+				void TestFrame(byte *f, uint16_t len, byte tag, const byte *dst)
+				{
+					memcpy(f, dst, 6);
+					memcpy(f + 6, TestPeer, 6);
+					f[12] = 0x08;
+					f[13] = 0x00;
+					for (uint16_t i = 14; i < len; ++i) f[i] = (byte)(i * 13 + tag);
+				}
+
+				bool TestFrameIs(const byte *data, uint16_t len, byte tag, const byte *dst)
+				{
+					byte f[MAX_FRAME_LENGTH];
+					TestFrame(f, len, tag, dst);
+
+					return memcmp(data, f, len) == 0;
+				}
+
+			}
+
+		}
+
+	}
+
+}
+
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+int main()
+{
+	int failed = 0;
+
+	for (auto& t : Tests())
+	{
+		ResetClock();
+
+		auto before = failures;
+		t.fn();
+
+		printf("%-32s %s\n", t.name, failures == before ? "ok" : "FAILED");
+		if (failures != before) ++failed;
+	}
+
+	printf("%u tests, %d failed\n", (unsigned)Tests().size(), failed);
+
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#ifndef _SEARCHATHING_ARDUINO_ENC28J60_HOST_TEST_H
+#define _SEARCHATHING_ARDUINO_ENC28J60_HOST_TEST_H
+
+#include <stdio.h>
+
+#include "Driver.h"
+#include "Emulator.h"
+#include "Host.h"
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			namespace Host
+			{
+
+				typedef void (*TestFn)();
+
+				// adds the test to those run by Main.cpp ( see TEST )
+				struct TestRegistration
+				{
+					TestRegistration(const char *name, TestFn fn);
+				};
+
+				void TestFail(const char *file, int line, const char *expr);
+
+				// emulator attached to the given CS pin ( and INT number ) for
+				// the scope of a test
+				struct TestChip
+				{
+					Emulator emu;
+
+					TestChip(uint8_t csPin = DPIN_CS, int intNum = -1);
+					~TestChip();
+				};
+
+				// station address of the drivers under test and of the other end
+				extern const byte TestMac[6];
+				extern const byte TestPeer[6];
+
+				// receive buffer of the tests
+				extern byte TestBuf[MAX_FRAME_LENGTH];
+
+				// len bytes ipv4 frame from TestPeer to dst, payload i * 13 + tag
+				void TestFrame(byte *f, uint16_t len, byte tag = 0, const byte *dst = TestMac);
+				// data starts with the TestFrame of the given len, tag and dst
+				bool TestFrameIs(const byte *data, uint16_t len, byte tag = 0, const byte *dst = TestMac);
+
+			}
+
+		}
+
+	}
+
+}
+
+// test body run on a fresh virtual clock
+#define TEST(name) \
+	static void name(); \
+	static SearchAThing::Arduino::Enc28j60::Host::TestRegistration name##Registration(#name, name); \
+	static void name()
+
+// reports the failed condition and goes on with the test
+#define CHECK(cond) \
+	do { if (!(cond)) SearchAThing::Arduino::Enc28j60::Host::TestFail(__FILE__, __LINE__, #cond); } while (0)
+
+#endif
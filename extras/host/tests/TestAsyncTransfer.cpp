@@ -0,0 +1,116 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+#include "EmulatorDmaSpi.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+// the read overlaps the caller work, data delivered once waited
+TEST(AsyncTransferOverlap)
+{
+	Emulator emu;
+	EmulatorDmaSpi dma(&emu);
+	Driver drv(dma, RamData(TestMac, sizeof(TestMac)));
+
+	byte f[590];
+	TestFrame(f, sizeof(f), 0);
+	CHECK(emu.Inject(f, sizeof(f)));
+
+	auto len = drv.BeginReceive();
+	CHECK(len == sizeof(f) + 4);
+	CHECK(drv.StartReadReceived(0, TestBuf, sizeof(f)) == sizeof(f));
+	CHECK(drv.TransferBusy());
+	CHECK(dma.Pending());
+
+	delayMicroseconds(100);
+	CHECK(drv.WaitTransfer());
+	CHECK(memcmp(TestBuf, f, sizeof(f)) == 0);
+	drv.EndReceive();
+}
+
+// aborted block : false from WaitTransfer, next frames unaffected
+TEST(AsyncTransferAbort)
+{
+	Emulator emu;
+	EmulatorDmaSpi dma(&emu);
+	Driver drv(dma, RamData(TestMac, sizeof(TestMac)));
+
+	byte f[200];
+	TestFrame(f, sizeof(f), 0);
+	CHECK(emu.Inject(f, sizeof(f)));
+	TestFrame(f, sizeof(f), 1);
+	CHECK(emu.Inject(f, sizeof(f)));
+
+	CHECK(drv.BeginReceive() == sizeof(f) + 4);
+	dma.FailNextBlock();
+	drv.StartReadReceived(0, TestBuf, sizeof(f));
+	CHECK(!drv.WaitTransfer());
+
+	// read pointer re-established by the next access
+	CHECK(drv.ReadReceived(0, TestBuf, 14) == 14);
+	CHECK(memcmp(TestBuf, f, 14) == 0);
+	drv.EndReceive();
+
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == sizeof(f) + 4);
+	CHECK(memcmp(TestBuf, f, sizeof(f)) == 0);
+}
+
+// controllers sharing the bus : b waits the block started by a instead of
+// selecting its chip in the middle of it
+TEST(AsyncTransferSharedBus)
+{
+	Emulator emuA, emuB;
+	EmulatorDmaSpi dmaA(&emuA), dmaB(&emuB);
+	Driver a(dmaA, RamData(TestMac, sizeof(TestMac)));
+	Driver b(dmaB, RamData(TestMac, sizeof(TestMac)));
+
+	byte fa[1000], fb[300];
+	TestFrame(fa, sizeof(fa), 0);
+	TestFrame(fb, sizeof(fb), 7);
+	CHECK(emuA.Inject(fa, sizeof(fa)));
+	CHECK(emuB.Inject(fb, sizeof(fb)));
+
+	static byte bufA[MAX_FRAME_LENGTH];
+	auto conflicts = EmulatorDmaSpi::BusConflicts();
+
+	CHECK(a.BeginReceive() == sizeof(fa) + 4);
+	a.StartReadReceived(0, bufA, sizeof(fa));
+	CHECK(dmaA.Pending());
+
+	CHECK(b.Receive(TestBuf, sizeof(TestBuf)) == sizeof(fb) + 4);
+	CHECK(!dmaA.Pending());
+	CHECK(EmulatorDmaSpi::BusConflicts() == conflicts);
+
+	CHECK(a.WaitTransfer());
+	a.EndReceive();
+
+	CHECK(memcmp(bufA, fa, sizeof(fa)) == 0);
+	CHECK(memcmp(TestBuf, fb, sizeof(fb)) == 0);
+}
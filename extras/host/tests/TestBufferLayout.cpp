@@ -0,0 +1,101 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+namespace
+{
+
+	uint16_t Peek16(TestChip& chip, byte craddress)
+	{
+		return chip.emu.Peek(craddress) | ((uint16_t)chip.emu.Peek(craddress + 1) << 8);
+	}
+
+}
+
+// #E14 - ERXRDPT on the odd ring end after init, whatever the layout
+TEST(BufferLayoutReadPtrInit)
+{
+	const BufferLayout layouts[] = { BufferLayoutDefault, BufferLayoutRxLarge, BufferLayoutTxHeavy, BufferLayoutScratch };
+
+	for (auto& layout : layouts)
+	{
+		TestChip chip;
+		Driver drv(RamData(TestMac, sizeof(TestMac)), layout, RestartCold);
+
+		auto rxEnd = Peek16(chip, ETH_ERXNDL);
+		CHECK(rxEnd == ETH_RX_BEGIN + drv.RxBufferSize() - 1);
+		CHECK(rxEnd % 2 == 1);
+		CHECK(Peek16(chip, ETH_ERXRDPTL) == rxEnd);
+
+		byte f[60];
+		TestFrame(f, sizeof(f));
+		CHECK(chip.emu.Inject(f, sizeof(f)));
+		CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 64);
+	}
+}
+
+// #E14 - a frame ending at the ring end moves ERXRDPT back to it
+TEST(BufferLayoutReadPtrWrap)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+
+	auto ring = drv.RxBufferSize();
+	auto rxEnd = Peek16(chip, ETH_ERXNDL);
+
+	// 60 bytes frames take 70 bytes ( #7.2.2 : 6 bytes header, FCS )
+	byte f[MAX_FRAME_LENGTH];
+	TestFrame(f, 60);
+	uint16_t pos = 0;
+	while (ring - pos > 1000)
+	{
+		CHECK(chip.emu.Inject(f, 60));
+		CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 64);
+		CHECK(Peek16(chip, ETH_ERXRDPTL) == pos + 70 - 1);
+		pos += 70;
+	}
+
+	// up to the ring end exactly
+	uint16_t last = ring - pos - 6 - 4;
+	TestFrame(f, last, 1);
+	CHECK(chip.emu.Inject(f, last));
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == last + 4);
+	CHECK(TestFrameIs(TestBuf, last, 1));
+	CHECK(Peek16(chip, ETH_ERXRDPTL) == rxEnd);
+
+	// next frame from the ring start
+	TestFrame(f, 100, 2);
+	CHECK(chip.emu.Inject(f, 100));
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 104);
+	CHECK(TestFrameIs(TestBuf, 100, 2));
+	CHECK(Peek16(chip, ETH_ERXRDPTL) == 110 - 1);
+}
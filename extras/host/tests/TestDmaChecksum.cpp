@@ -0,0 +1,135 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+namespace
+{
+
+	// one's complement checksum of len bytes plus partial
+	uint16_t Sum(const byte *b, uint16_t len, uint32_t s = 0)
+	{
+		for (uint16_t i = 0; i < len; i += 2)
+			s += (uint16_t)((b[i] << 8) | (i + 1 < len ? b[i + 1] : 0));
+
+		while (s >> 16) s = (s & 0xFFFF) + (s >> 16);
+
+		return ~s;
+	}
+
+}
+
+// 1000 bytes summed by the DMA : 44 SPI bytes
+TEST(DmaChecksumTx)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	byte frame[MAX_FRAME_LENGTH];
+	TestFrame(frame, sizeof(frame));
+	std::vector<byte> out;
+
+	// ipv4 header checksum field
+	frame[24] = frame[25] = 0;
+
+	CHECK(drv.BeginTransmit());
+	CHECK(drv.WriteTransmit(frame, 1000) == 1000);
+
+	CHECK(drv.TxChecksum(14, 1) == Sum(frame + 14, 1));
+	CHECK(drv.TxChecksum(100, 777, 0x1234) == Sum(frame + 100, 777, 0x1234));
+
+	chip.emu.ClearCounters();
+	auto c = drv.TxChecksum(0, 1000);
+#if ETH_SOFT_CHECKSUM
+	// #E15 - read over SPI
+	CHECK(chip.emu.GetCounters().bytes == 1005);
+#else
+	CHECK(chip.emu.GetCounters().bytes == 44);
+#endif
+	CHECK(c == Sum(frame, 1000));
+
+	CHECK(drv.PatchTxChecksum(14, 20, 24));
+	CHECK(drv.EndTransmit());
+	CHECK(chip.emu.PopTransmitted(out) && out.size() == 1000);
+	CHECK(Sum(out.data() + 14, 20) == 0);
+}
+
+// ranges of received frames, rx ring wrap included
+TEST(DmaChecksumRx)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	byte frame[MAX_FRAME_LENGTH];
+	TestFrame(frame, sizeof(frame));
+	std::vector<byte> out;
+
+	for (int r = 0; r < 60; ++r)
+	{
+		uint16_t sz = 100 + r * 23;
+		chip.emu.Inject(frame, sz);
+
+		CHECK(drv.BeginReceive() == sz + 4);
+		CHECK(drv.RxChecksum(14, 20) == Sum(frame + 14, 20));
+
+		uint16_t off = r * 7 % sz;
+		CHECK(drv.RxChecksum(off, sz - off, 77) == Sum(frame + off, sz - off, 77));
+		CHECK(drv.RxChecksum(sz, 10) == 0);
+
+		drv.EndReceive();
+	}
+
+	// ECON1 shadow consistent after the DMA
+	chip.emu.Inject(frame, 300);
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 304);
+	CHECK(drv.Transmit(frame, 300) && chip.emu.PopTransmitted(out) && out.size() == 300);
+}
+
+// DMA engine whatever ETH_SOFT_CHECKSUM : 12 SPI bytes to start it
+TEST(DmaChecksumStart)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	byte frame[MAX_FRAME_LENGTH];
+	TestFrame(frame, sizeof(frame));
+
+	// #7-1 frame data after the 6 bytes header
+	CHECK(chip.emu.Inject(frame, 1000));
+
+	chip.emu.ClearCounters();
+	CHECK(drv.StartDmaChecksum(ETH_RX_BEGIN + 6, 1000));
+	CHECK(chip.emu.GetCounters().bytes == 12);
+	while (drv.DmaBusy()) delayMicroseconds(ETH_DMA_POLL_US);
+	CHECK(drv.DmaChecksum() == Sum(frame, 1000));
+
+	CHECK(!drv.StartDmaChecksum(ETH_RX_BEGIN, 0));
+
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 1004);
+	CHECK(memcmp(TestBuf, frame, 1000) == 0);
+}
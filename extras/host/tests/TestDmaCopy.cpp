@@ -0,0 +1,107 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+// echo through the DMA copy : only the swapped MACs cross the bus ( 1409
+// bytes frame : 113 SPI bytes, 2867 when read and written back )
+TEST(DmaCopyEcho)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	byte frame[MAX_FRAME_LENGTH];
+	TestFrame(frame, sizeof(frame));
+	std::vector<byte> out;
+
+	for (int r = 0; r < 80; ++r)
+	{
+		uint16_t sz = 60 + (r * 71) % 1454;
+		frame[30] = r;
+
+		chip.emu.Inject(frame, sz);
+		chip.emu.ClearCounters();
+
+		auto len = drv.BeginReceive();
+		CHECK(len == sz + 4);
+		CHECK(drv.BeginTransmit());
+		CHECK(drv.CopyReceived(0, len - 4, 0) == sz);
+		drv.PatchTransmit(0, TestPeer, 6);
+		drv.PatchTransmit(6, TestMac, 6);
+		drv.EndReceive();
+		CHECK(drv.StartTransmit());
+
+		if (sz == 1409) CHECK(chip.emu.GetCounters().bytes == 113);
+
+		CHECK(drv.WaitTransmit() == TxDone);
+		CHECK(chip.emu.PopTransmitted(out) && out.size() == sz);
+		CHECK(memcmp(out.data(), TestPeer, 6) == 0 && memcmp(out.data() + 6, TestMac, 6) == 0);
+		CHECK(memcmp(out.data() + 12, frame + 12, sz - 12) == 0);
+	}
+
+	// same echo read and written back
+	chip.emu.Inject(frame, 1409);
+	chip.emu.ClearCounters();
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 1413);
+	memcpy(TestBuf, TestPeer, 6);
+	memcpy(TestBuf + 6, TestMac, 6);
+	CHECK(drv.StartTransmit(TestBuf, 1409));
+	CHECK(chip.emu.GetCounters().bytes == 2867);
+}
+
+// copies to an offset of the frame being written, clamped to the frame
+TEST(DmaCopyRanges)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	byte frame[MAX_FRAME_LENGTH];
+	TestFrame(frame, sizeof(frame));
+	std::vector<byte> out;
+
+	chip.emu.Inject(frame, 500);
+	CHECK(drv.BeginReceive() == 504);
+	CHECK(drv.BeginTransmit());
+	drv.WriteTransmit(frame, 14);
+
+	CHECK(drv.CopyReceived(100, 50, 14) == 50);
+	// past the bytes written
+	CHECK(drv.CopyReceived(100, 50, 70) == 0);
+	// clamped at the received length ( FCS included )
+	CHECK(drv.CopyReceived(490, 50, 64) == 14);
+
+	drv.EndReceive();
+	CHECK(drv.EndTransmit());
+	CHECK(chip.emu.PopTransmitted(out) && out.size() == 78);
+	CHECK(memcmp(out.data() + 14, frame + 100, 50) == 0);
+	CHECK(memcmp(out.data() + 64, frame + 490, 10) == 0);
+
+	chip.emu.Inject(frame, 300);
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 304);
+}
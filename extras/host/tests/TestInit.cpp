@@ -0,0 +1,112 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+// constructor bounded without controller, InitFailed after ETH_INIT_RETRIES,
+// Reinit recovers once the controller answers
+TEST(InitAbsent)
+{
+	auto t0 = millis();
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	CHECK(millis() - t0 <= ETH_INIT_TIMEOUT_MS + 2);
+	CHECK(drv.InitState() == InitReset);
+
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 0);
+	CHECK(!drv.Transmit(TestBuf, 60));
+
+	for (int i = 0; i < 5000 && drv.PollInit() != InitFailed; ++i) delay(1);
+	CHECK(drv.InitState() == InitFailed);
+	CHECK(drv.PollInit() == InitFailed);
+
+	TestChip chip;
+	drv.Reinit();
+	CHECK(drv.InitState() == InitReset);
+	for (int i = 0; i < 100 && drv.PollInit() != InitReady; ++i) delay(1);
+	CHECK(drv.InitState() == InitReady);
+
+	byte f[60];
+	TestFrame(f, sizeof(f));
+	CHECK(chip.emu.Inject(f, sizeof(f)));
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 64);
+}
+
+// configured without link : rx enabled by Receive as soon as the link is up
+TEST(InitNoLink)
+{
+	TestChip chip;
+	chip.emu.SetLink(false);
+
+	auto t0 = millis();
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	CHECK(millis() - t0 <= ETH_INIT_TIMEOUT_MS + 2);
+	CHECK(drv.InitState() == InitLink);
+
+	byte f[60];
+	TestFrame(f, sizeof(f));
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 0);
+	CHECK(!chip.emu.Inject(f, sizeof(f)));
+
+	chip.emu.SetLink(true);
+	delay(ETH_LINK_POLL_MS);
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 0);
+	CHECK(drv.InitState() == InitReady);
+
+	CHECK(chip.emu.Inject(f, sizeof(f)));
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 64);
+}
+
+// Reinit from InitReady : queued frames dropped, brought up again
+TEST(InitReinit)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	CHECK(drv.InitState() == InitReady);
+
+	byte f[60];
+	TestFrame(f, sizeof(f));
+	CHECK(drv.StartTransmit(f, sizeof(f)));
+
+	drv.Reinit();
+	CHECK(drv.TxSlotsFree() == BufferLayoutDefault.txSlots);
+	CHECK(drv.PollInit() == InitReady);
+
+	CHECK(chip.emu.Inject(f, sizeof(f)));
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 64);
+}
+
+// default constructed : default layout and script until Setup
+TEST(InitDefaultDriver)
+{
+	Driver drv;
+	CHECK(drv.InitState() == InitReset);
+	CHECK(drv.TxSlotsFree() == BufferLayoutDefault.txSlots);
+}
@@ -0,0 +1,109 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+namespace
+{
+
+	const RegWrite TestRegs[] PROGMEM =
+	{
+		{ ETH_MACON1, ETH_MACON1_MARXEN },
+		{ ETH_MACON3, ETH_MACON3_PADCFG0 | ETH_MACON3_TXCRCEN | ETH_MACON3_FRMLNEN }
+	};
+
+	// back to back PHY writes
+	const PhyRegWrite TestPhyRegs[] PROGMEM =
+	{
+		{ ETH_PHCON1, 0 },
+		{ ETH_PHCON2, ETH_PHCON2_HDLDIS },
+		{ ETH_PHIE, 0 },
+		{ 0x14, 0x3472 } // PHLCON ( #2.6 )
+	};
+
+	const InitScript TestScript =
+	{
+		TestRegs, sizeof(TestRegs) / sizeof(RegWrite),
+		TestPhyRegs, sizeof(TestPhyRegs) / sizeof(PhyRegWrite)
+	};
+
+}
+
+// #6.5 - full-duplex MAC, #6.6 - PHY loopback disabled
+TEST(InitScriptDefaultRegs)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)), BufferLayoutDefault, RestartCold);
+
+	CHECK(chip.emu.Peek(ETH_MACON1) == (ETH_MACON1_TXPAUS | ETH_MACON1_RXPAUS | ETH_MACON1_MARXEN));
+	CHECK(chip.emu.Peek(ETH_MACON3) == (ETH_MACON3_PADCFG0 | ETH_MACON3_TXCRCEN | ETH_MACON3_FRMLNEN | ETH_MACON3_FULDPX));
+	CHECK(chip.emu.Peek(ETH_MABBIPG) == 0x15);
+	CHECK(chip.emu.Peek(ETH_MAMXFL) == lowByte(MAX_FRAME_LENGTH));
+	CHECK(chip.emu.Peek(ETH_MAMXFH) == highByte(MAX_FRAME_LENGTH));
+	CHECK(chip.emu.PeekPhy(ETH_PHCON2) == ETH_PHCON2_HDLDIS);
+
+	// #3.2 and bank 3 left as set by the driver
+	CHECK(chip.emu.Peek(ETH_MAADR1) == TestMac[0]);
+	CHECK(chip.emu.Peek(ETH_MAADR6) == TestMac[5]);
+
+	byte f[60];
+	TestFrame(f, sizeof(f));
+	CHECK(chip.emu.Inject(f, sizeof(f)));
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 64);
+	CHECK(drv.Transmit(f, sizeof(f)));
+}
+
+// #6.5 - half-duplex MAC and PHY
+TEST(InitScriptHalfDuplexRegs)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)), BufferLayoutDefault, RestartCold, InitScriptHalfDuplex);
+
+	CHECK(chip.emu.Peek(ETH_MACON1) == ETH_MACON1_MARXEN);
+	CHECK(!(chip.emu.Peek(ETH_MACON3) & ETH_MACON3_FULDPX));
+	CHECK(chip.emu.Peek(ETH_MACON4) == ETH_MACON4_DEFER);
+	CHECK(chip.emu.Peek(ETH_MABBIPG) == 0x12);
+	CHECK(chip.emu.PeekPhy(ETH_PHCON1) == 0);
+	CHECK(chip.emu.PeekPhy(ETH_PHCON2) == ETH_PHCON2_HDLDIS);
+}
+
+// #3.3.2 - each PHY write waits MISTAT.BUSY of the previous one; the last
+// one of the script is waited by the PHIE write that follows
+TEST(InitScriptPhyBusy)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)), BufferLayoutDefault, RestartCold, TestScript);
+
+	CHECK(chip.emu.GetCounters().miiBusyOps == 0);
+	CHECK(chip.emu.PeekPhy(ETH_PHCON2) == ETH_PHCON2_HDLDIS);
+	CHECK(chip.emu.PeekPhy(0x14) == 0x3472);
+	CHECK(drv.InitState() == InitReady);
+}
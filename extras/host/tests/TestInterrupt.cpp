@@ -0,0 +1,158 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+// INT pin armed and no frame : Receive costs no SPI transaction
+TEST(InterruptIdleReceive)
+{
+	TestChip chip(DPIN_CS, digitalPinToInterrupt(DPIN_INT));
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	byte frame[MAX_FRAME_LENGTH];
+	TestFrame(frame, sizeof(frame));
+
+	CHECK(drv.EnableInterrupt(DPIN_INT));
+
+	// first empty poll arms INTIE
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 0);
+
+	chip.emu.ClearCounters();
+	for (int i = 0; i < 100; ++i) CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 0);
+	CHECK(chip.emu.GetCounters().transactions == 0);
+	CHECK(!drv.InterruptPending());
+
+	chip.emu.Inject(frame, 100);
+	CHECK(drv.InterruptPending());
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 104);
+	CHECK(memcmp(TestBuf, frame, 100) == 0);
+
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 0);
+	chip.emu.ClearCounters();
+	for (int i = 0; i < 10; ++i) drv.Receive(TestBuf, sizeof(TestBuf));
+	CHECK(chip.emu.GetCounters().transactions == 0);
+}
+
+// frames arriving while the ring is drained raise a new edge ( #E6 )
+TEST(InterruptBursts)
+{
+	TestChip chip(DPIN_CS, digitalPinToInterrupt(DPIN_INT));
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	byte frame[MAX_FRAME_LENGTH];
+	TestFrame(frame, sizeof(frame));
+
+	CHECK(drv.EnableInterrupt(DPIN_INT));
+	drv.Receive(TestBuf, sizeof(TestBuf));
+
+	for (int r = 0; r < 50; ++r)
+	{
+		int n = r % 5 + 1;
+		for (int i = 0; i < n; ++i) chip.emu.Inject(frame, 60 + r * 10);
+
+		int c = 0;
+		while (drv.Receive(TestBuf, sizeof(TestBuf)))
+		{
+			if (++c == 1 && r % 3 == 0)
+			{
+				chip.emu.Inject(frame, 70);
+				++n;
+			}
+		}
+
+		CHECK(c == n);
+	}
+
+	chip.emu.ClearCounters();
+	for (int i = 0; i < 10; ++i) drv.Receive(TestBuf, sizeof(TestBuf));
+	CHECK(chip.emu.GetCounters().transactions == 0);
+}
+
+// tx completion and link changes serviced through the isr
+TEST(InterruptTxAndLink)
+{
+	TestChip chip(DPIN_CS, digitalPinToInterrupt(DPIN_INT));
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	byte frame[MAX_FRAME_LENGTH];
+	TestFrame(frame, sizeof(frame));
+	std::vector<byte> out;
+
+	CHECK(drv.EnableInterrupt(DPIN_INT));
+	drv.Receive(TestBuf, sizeof(TestBuf));
+
+	CHECK(drv.StartTransmit(frame, 500));
+	while (drv.PollTransmit() == TxPending)
+	{
+		drv.Receive(TestBuf, sizeof(TestBuf));
+		delayMicroseconds(5);
+	}
+	CHECK(chip.emu.PopTransmitted(out) && out.size() == 500);
+
+	chip.emu.FailNextTransmit(false);
+	CHECK(drv.Transmit(frame, 200));
+	CHECK(chip.emu.PopTransmitted(out));
+
+	// INTIE armed again by the empty poll
+	drv.Receive(TestBuf, sizeof(TestBuf));
+	drv.Receive(TestBuf, sizeof(TestBuf));
+
+	chip.emu.SetLink(false);
+	CHECK(drv.InterruptPending());
+	drv.Receive(TestBuf, sizeof(TestBuf));
+	CHECK(drv.LineStatus() == LineStatusEnum::LinkDown);
+
+	chip.emu.SetLink(true);
+	drv.Receive(TestBuf, sizeof(TestBuf));
+	CHECK(drv.LineStatus() == LineStatusEnum::LinkUp);
+
+	drv.Receive(TestBuf, sizeof(TestBuf));
+	chip.emu.ClearCounters();
+	for (int i = 0; i < 10; ++i) drv.Receive(TestBuf, sizeof(TestBuf));
+	CHECK(chip.emu.GetCounters().transactions == 0);
+
+	drv.DisableInterrupt();
+	chip.emu.Inject(frame, 100);
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 104);
+}
+
+// a pin without external interrupt is refused and rx keeps polling
+TEST(InterruptPinRefused)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	byte frame[MAX_FRAME_LENGTH];
+	TestFrame(frame, sizeof(frame));
+
+	CHECK(!drv.EnableInterrupt(7));
+	CHECK(chip.emu.Peek(ETH_EIE) == 0);
+
+	drv.Receive(TestBuf, sizeof(TestBuf));
+	chip.emu.Inject(frame, 100);
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 104);
+}
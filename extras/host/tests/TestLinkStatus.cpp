@@ -0,0 +1,89 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+// polling mode : cached status, EIR read at most every ETH_LINK_POLL_MS
+TEST(LinkStatusPolling)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	auto& st = drv.Stats();
+
+	CHECK(drv.LineStatus() == LineStatusEnum::LinkUp);
+
+	auto spi = st.spiTransactions;
+	for (int i = 0; i < 1000; ++i) drv.LineStatus();
+	CHECK(st.spiTransactions == spi);
+
+	// EIR only, PHSTAT2 left alone without LINKIF
+	delay(ETH_LINK_POLL_MS);
+	CHECK(drv.LineStatus() == LineStatusEnum::LinkUp);
+	CHECK(st.spiTransactions == spi + 1);
+
+	chip.emu.SetLink(false);
+	CHECK(drv.LineStatus() == LineStatusEnum::LinkUp);
+	delay(ETH_LINK_POLL_MS);
+	CHECK(drv.LineStatus() == LineStatusEnum::LinkDown);
+
+	chip.emu.SetLink(true);
+	delay(ETH_LINK_POLL_MS);
+	CHECK(drv.LineStatus() == LineStatusEnum::LinkUp);
+}
+
+// interrupt mode : no SPI until the PHY interrupt fires
+TEST(LinkStatusInterrupt)
+{
+	TestChip chip(DPIN_CS, digitalPinToInterrupt(DPIN_INT));
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	auto& st = drv.Stats();
+
+	CHECK(drv.EnableInterrupt(DPIN_INT));
+	drv.Receive(TestBuf, sizeof(TestBuf));
+
+	auto spi = st.spiTransactions;
+	delay(100);
+	for (int i = 0; i < 100; ++i) CHECK(drv.LineStatus() == LineStatusEnum::LinkUp);
+	CHECK(st.spiTransactions == spi);
+
+	chip.emu.SetLink(false);
+	CHECK(drv.InterruptPending());
+	CHECK(drv.LineStatus() == LineStatusEnum::LinkDown);
+
+	drv.Receive(TestBuf, sizeof(TestBuf));
+	chip.emu.SetLink(true);
+	CHECK(drv.LineStatus() == LineStatusEnum::LinkUp);
+
+	drv.DisableInterrupt();
+	chip.emu.SetLink(false);
+	delay(ETH_LINK_POLL_MS);
+	CHECK(drv.LineStatus() == LineStatusEnum::LinkDown);
+}
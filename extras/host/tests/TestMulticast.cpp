@@ -0,0 +1,165 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+namespace
+{
+
+	byte mdns[] = { 0x01, 0x00, 0x5e, 0x00, 0x00, 0xfb };
+	byte ssdp[] = { 0x01, 0x00, 0x5e, 0x7f, 0xff, 0xfa };
+	byte other[] = { 0x01, 0x00, 0x5e, 0x01, 0x02, 0x03 };
+
+	bool Rx(TestChip& chip, Driver& drv, const byte *dst)
+	{
+		byte f[60];
+		TestFrame(f, sizeof(f), 0, dst);
+
+		chip.emu.Inject(f, sizeof(f));
+
+		return drv.Receive(TestBuf, sizeof(TestBuf)) == sizeof(f) + 4;
+	}
+
+	void HashTable(TestChip& chip, byte *eht)
+	{
+		for (byte i = 0; i < 8; ++i) eht[i] = chip.emu.Peek(ETH_EHT0 + i);
+	}
+
+}
+
+// joins are counted; HTEN set while any group is joined
+TEST(MulticastJoinLeave)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+
+	CHECK(!Rx(chip, drv, mdns));
+
+	CHECK(drv.JoinMulticast(mdns));
+	CHECK(Rx(chip, drv, mdns));
+	CHECK(!Rx(chip, drv, ssdp));
+	CHECK(Rx(chip, drv, TestMac));
+
+	CHECK(drv.JoinMulticast(ssdp));
+	CHECK(drv.JoinMulticast(mdns));
+	CHECK(Rx(chip, drv, mdns) && Rx(chip, drv, ssdp) && !Rx(chip, drv, other));
+
+	CHECK(drv.LeaveMulticast(mdns));
+	CHECK(Rx(chip, drv, mdns));
+	CHECK(drv.LeaveMulticast(mdns));
+	CHECK(!Rx(chip, drv, mdns));
+	CHECK(Rx(chip, drv, ssdp));
+	CHECK(!drv.LeaveMulticast(mdns));
+
+	CHECK(drv.LeaveMulticast(ssdp));
+	CHECK(!Rx(chip, drv, ssdp));
+	CHECK(!(drv.RxFilter() & ETH_ERXFCON_HTEN));
+
+	for (byte i = 0; i < ETH_MCAST_GROUPS; ++i)
+	{
+		byte m[] = { 0x01, 0x00, 0x5e, 0x00, 0x09, i };
+		CHECK(drv.JoinMulticast(m));
+	}
+	CHECK(!drv.JoinMulticast(other));
+}
+
+// leaving a group keeps the hash bit another joined group shares
+TEST(MulticastSharedHashBit)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+
+	byte a[] = { 0x01, 0x00, 0x5e, 0x00, 0x00, 0x01 };
+	byte b[6];
+	bool found = false;
+
+	for (int i = 2; i < 5000 && !found; ++i)
+	{
+		byte ea[8], eb[8];
+
+		memcpy(b, a, 6);
+		b[4] = highByte(i);
+		b[5] = lowByte(i);
+
+		drv.JoinMulticast(b);
+		HashTable(chip, eb);
+		drv.LeaveMulticast(b);
+
+		drv.JoinMulticast(a);
+		HashTable(chip, ea);
+		drv.LeaveMulticast(a);
+
+		found = memcmp(ea, eb, 8) == 0;
+	}
+	CHECK(found);
+
+	drv.JoinMulticast(a);
+	drv.JoinMulticast(b);
+	drv.LeaveMulticast(a);
+	CHECK(Rx(chip, drv, b));
+	drv.LeaveMulticast(b);
+	CHECK(!Rx(chip, drv, b));
+}
+
+// AND mode : joins refused, unicast still received
+TEST(MulticastAndMode)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+
+	drv.SetRxFilter(ETH_ERXFCON_CRCEN | ETH_ERXFCON_ANDOR | ETH_ERXFCON_UCEN);
+	CHECK(!drv.JoinMulticast(mdns));
+	CHECK(!(drv.RxFilter() & ETH_ERXFCON_HTEN));
+	CHECK(Rx(chip, drv, TestMac));
+
+	// groups joined in OR mode don't leak HTEN into a later AND filter
+	drv.SetRxFilter(ETH_ERXFCON_CRCEN | ETH_ERXFCON_UCEN);
+	CHECK(drv.JoinMulticast(mdns));
+	drv.SetRxFilter(ETH_ERXFCON_CRCEN | ETH_ERXFCON_ANDOR | ETH_ERXFCON_UCEN);
+	CHECK(!(drv.RxFilter() & ETH_ERXFCON_HTEN));
+	CHECK(Rx(chip, drv, TestMac));
+}
+
+// accepting all ( filter 0 ) isn't narrowed by a join
+TEST(MulticastPromiscuous)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+
+	drv.SetRxFilter(0);
+	CHECK(drv.JoinMulticast(mdns));
+	CHECK(drv.RxFilter() == 0);
+	CHECK(Rx(chip, drv, other));
+
+	drv.SetRxFilter(ETH_ERXFCON_CRCEN | ETH_ERXFCON_UCEN);
+	CHECK(Rx(chip, drv, mdns));
+	CHECK(!Rx(chip, drv, other));
+}
@@ -0,0 +1,124 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+namespace
+{
+
+	byte bufs[8][600];
+	RxFrame frames[8];
+
+	void InitFrames()
+	{
+		for (byte i = 0; i < 8; ++i) frames[i] = { bufs[i], sizeof(bufs[i]), 0 };
+	}
+
+}
+
+// six 100 bytes frames : 28 SPI transactions with Receive, 13 with ReceiveBatch
+// ( EPKTCNT and EIR read once )
+TEST(ReceiveBatchTransactions)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	byte frame[MAX_FRAME_LENGTH];
+	TestFrame(frame, sizeof(frame));
+	InitFrames();
+
+	// first receive after init excluded
+	chip.emu.Inject(frame, 100);
+	drv.Receive(TestBuf, sizeof(TestBuf));
+
+	for (int i = 0; i < 6; ++i) chip.emu.Inject(frame, 100);
+	chip.emu.ClearCounters();
+	for (int i = 0; i < 6; ++i) CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 104);
+	CHECK(chip.emu.GetCounters().transactions == 28);
+
+	for (int i = 0; i < 6; ++i) chip.emu.Inject(frame, 100);
+	chip.emu.ClearCounters();
+	CHECK(drv.ReceiveBatch(frames, 8) == 6);
+	CHECK(chip.emu.GetCounters().transactions == 13);
+
+	for (int i = 0; i < 6; ++i) CHECK(frames[i].len == 104 && memcmp(bufs[i], frame, 100) == 0);
+
+	CHECK(drv.ReceiveBatch(frames, 8) == 0);
+}
+
+// random sizes across ring wraps; frames over capacity dropped ( len 0 )
+TEST(ReceiveBatchDropsAndWraps)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	byte frame[MAX_FRAME_LENGTH];
+	TestFrame(frame, sizeof(frame));
+	InitFrames();
+
+	for (int r = 0; r < 300; ++r)
+	{
+		int n = r % 7 + 1;
+		int sz[8];
+
+		for (int i = 0; i < n; ++i)
+		{
+			sz[i] = 60 + ((r * 7 + i * 131) % 700);
+			frame[20] = r;
+			frame[21] = i;
+			CHECK(chip.emu.Inject(frame, sz[i]));
+		}
+
+		int got = 0;
+		while (got < n)
+		{
+			byte c = drv.ReceiveBatch(frames, 3);
+			CHECK(c > 0);
+			if (c == 0) return;
+
+			for (int k = 0; k < c; ++k, ++got)
+			{
+				if (sz[got] + 4 > (int)sizeof(bufs[k]))
+					CHECK(frames[k].len == 0);
+				else
+				{
+					CHECK(frames[k].len == sz[got] + 4);
+					CHECK(bufs[k][20] == (byte)r && bufs[k][21] == got);
+					CHECK(memcmp(bufs[k] + 22, frame + 22, sz[got] - 22) == 0);
+				}
+			}
+		}
+	}
+
+	CHECK(drv.ReceiveBatch(frames, 8) == 0);
+	CHECK(drv.Stats().rxDropped > 0);
+
+	chip.emu.Inject(frame, 100);
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 104);
+}
@@ -0,0 +1,135 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+namespace
+{
+
+	// len bytes frame to dst with the given ethertype
+	bool Rx(TestChip& chip, Driver& drv, const byte *dst, uint16_t type = 0x0800, uint16_t len = 60)
+	{
+		byte f[100];
+		TestFrame(f, sizeof(f), 0, dst);
+		f[12] = highByte(type);
+		f[13] = lowByte(type);
+
+		chip.emu.Inject(f, len);
+
+		return drv.Receive(TestBuf, sizeof(TestBuf)) == len + 4;
+	}
+
+}
+
+// default : unicast and broadcast ARP only
+TEST(RxFilterDefault)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+
+	byte bcast[6];
+	memset(bcast, 0xff, sizeof(bcast));
+
+	CHECK(Rx(chip, drv, bcast, 0x0806));
+	CHECK(!Rx(chip, drv, bcast, 0x0800));
+	CHECK(Rx(chip, drv, TestMac));
+}
+
+// UDP to port 50000 in AND with unicast, then OR
+TEST(RxFilterPattern)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+
+	byte udp[100];
+	memset(udp, 0, sizeof(udp));
+	memcpy(udp, TestMac, 6);
+	udp[12] = 0x08; udp[14] = 0x45; udp[23] = 17;
+	udp[36] = highByte(50000); udp[37] = lowByte(50000);
+
+	PatternFilter f;
+	CHECK(f.Match16(12, 0x0800));
+	CHECK(f.Match8(23, 17));
+	CHECK(f.Match16(36, 50000));
+	// outside the 64 bytes window
+	CHECK(!f.Match16(63, 1));
+
+	drv.SetPatternFilter(f);
+	drv.SetRxFilter(ETH_ERXFCON_CRCEN | ETH_ERXFCON_ANDOR | ETH_ERXFCON_UCEN | ETH_ERXFCON_PMEN);
+
+	chip.emu.Inject(udp, 100);
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 104);
+
+	++udp[37];
+	chip.emu.Inject(udp, 100);
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 0);
+	--udp[37];
+
+	udp[5] = 7;
+	chip.emu.Inject(udp, 100);
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 0);
+
+	drv.SetRxFilter(ETH_ERXFCON_CRCEN | ETH_ERXFCON_PMEN);
+	chip.emu.Inject(udp, 100);
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 104);
+
+	// window at offset 12 : frames shorter than its end never match
+	PatternFilter g(12);
+	CHECK(!g.Match8(11, 0));
+	CHECK(g.Match16(12, 0x88B5));
+	drv.SetPatternFilter(g);
+
+	CHECK(!Rx(chip, drv, TestMac, 0x88B5, 60));
+	CHECK(Rx(chip, drv, udp, 0x88B5, 80));
+
+	drv.SetRxFilter(0);
+	CHECK(drv.RxFilter() == 0);
+	CHECK(Rx(chip, drv, udp, 0x0800));
+}
+
+// a filter change keeps the hash table enabled for the joined groups
+TEST(RxFilterKeepsMulticast)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+
+	byte mdns[] = { 0x01, 0x00, 0x5e, 0x00, 0x00, 0xfb };
+
+	CHECK(drv.JoinMulticast(mdns));
+	drv.SetRxFilter(ETH_ERXFCON_CRCEN | ETH_ERXFCON_UCEN);
+	CHECK(drv.RxFilter() & ETH_ERXFCON_HTEN);
+	CHECK(Rx(chip, drv, mdns));
+	CHECK(Rx(chip, drv, TestMac));
+
+	CHECK(drv.LeaveMulticast(mdns));
+	CHECK(!(drv.RxFilter() & ETH_ERXFCON_HTEN));
+	CHECK(!Rx(chip, drv, mdns));
+}
@@ -0,0 +1,162 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+#include "EmulatorSpidev.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+// SpidevTransport Begin and messages run unchanged on the faked syscalls
+TEST(SpidevDriver)
+{
+	Emulator emu;
+	EmulatorSpidev spidev(&emu);
+	Driver drv(spidev, RamData(TestMac, sizeof(TestMac)));
+
+	CHECK(spidev.IsOpen());
+	CHECK(drv.InitState() == InitReady);
+
+	byte f[60];
+	TestFrame(f, sizeof(f));
+
+	CHECK(emu.Inject(f, sizeof(f)));
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 64);
+	CHECK(memcmp(TestBuf, f, sizeof(f)) == 0);
+
+	std::vector<byte> out;
+	CHECK(drv.Transmit(f, sizeof(f)));
+	CHECK(emu.PopTransmitted(out) && out.size() == sizeof(f));
+
+	CHECK(spidev.Errors() == 0);
+
+	// reopened after End
+	spidev.End();
+	CHECK(!spidev.IsOpen());
+	spidev.Begin();
+	CHECK(spidev.IsOpen());
+}
+
+// failed message : counted, read as an idle bus
+TEST(SpidevErrors)
+{
+	Emulator emu;
+	EmulatorSpidev spidev(&emu);
+	spidev.Begin();
+	CHECK(spidev.IsOpen());
+
+	spidev.Select();
+	spidev.FailNextMessage();
+	CHECK(spidev.Transfer(0) == 0xFF);
+	CHECK(spidev.Errors() == 1);
+
+	byte data[8] = { 0 };
+	spidev.FailNextMessage();
+	spidev.ReadBlock(data, sizeof(data));
+	for (auto b : data) CHECK(b == 0xFF);
+	CHECK(spidev.Errors() == 2);
+
+	// the next message reaches the emulator
+	CHECK(emu.GetCounters().bytes == 0);
+	spidev.Transfer(0);
+	spidev.Deselect();
+	CHECK(emu.GetCounters().bytes == 1);
+	CHECK(spidev.Errors() == 2);
+
+	// messages before Begin
+	spidev.End();
+	spidev.Select();
+	CHECK(spidev.Transfer(0) == 0xFF);
+	spidev.Deselect();
+	CHECK(spidev.Errors() == 4);
+}
+
+// writes queued up to the next read or Deselect : one ioctl per register
+// write or WBM block
+TEST(SpidevBatch)
+{
+	Emulator emu;
+	EmulatorSpidev spidev(&emu);
+	spidev.Begin();
+
+	// #4.2.2 - WCR
+	spidev.Select();
+	spidev.Write(ETH_SPIOP_WCR | ETH_CRA_REG(ETH_EIE));
+	spidev.Write(ETH_EIE_PKTIE);
+	CHECK(spidev.Messages() == 0);
+	spidev.Deselect();
+	CHECK(spidev.Messages() == 1);
+	CHECK(emu.Peek(ETH_EIE) == ETH_EIE_PKTIE);
+
+	// #4.2.1 - RCR : opcode and data byte in the message of the read
+	spidev.Select();
+	spidev.Write(ETH_SPIOP_RCR | ETH_CRA_REG(ETH_EIE));
+	CHECK(spidev.Transfer(0) == ETH_EIE_PKTIE);
+	CHECK(spidev.Messages() == 2);
+	spidev.Deselect();
+	CHECK(spidev.Messages() == 3);
+	CHECK(emu.GetCounters().transactions == 2);
+
+	// CS released between transactions : the next opcode is decoded
+	spidev.Select();
+	spidev.Write(ETH_SPIOP_BFC | ETH_CRA_REG(ETH_EIE));
+	spidev.Write(ETH_EIE_PKTIE);
+	spidev.Deselect();
+	CHECK(emu.Peek(ETH_EIE) == 0);
+
+	// failed message : queued writes dropped with it
+	spidev.Select();
+	spidev.Write(ETH_SPIOP_WCR | ETH_CRA_REG(ETH_EIE));
+	spidev.Write(ETH_EIE_PKTIE);
+	spidev.FailNextMessage();
+	spidev.Deselect();
+	CHECK(spidev.Errors() == 1);
+	CHECK(emu.Peek(ETH_EIE) == 0);
+}
+
+// driver over spidev : block writes in one ioctl with their opcode
+TEST(SpidevDriverMessages)
+{
+	Emulator emu;
+	EmulatorSpidev spidev(&emu);
+	Driver drv(spidev, RamData(TestMac, sizeof(TestMac)));
+
+	byte f[60];
+	TestFrame(f, sizeof(f));
+
+	std::vector<byte> out;
+	drv.ResetStats();
+	auto m0 = spidev.Messages();
+	CHECK(drv.Transmit(f, sizeof(f)));
+	CHECK(emu.PopTransmitted(out) && out.size() == sizeof(f));
+
+	// one ioctl per write transaction, two per read ( data, then CS release )
+	auto t = drv.Stats().spiTransactions;
+	CHECK(spidev.Messages() - m0 < 2 * t);
+	CHECK(spidev.Errors() == 0);
+}
@@ -0,0 +1,140 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+TEST(StatsReceive)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	byte frame[100];
+	TestFrame(frame, sizeof(frame));
+
+	drv.ResetStats();
+	auto& st = drv.Stats();
+
+	chip.emu.Inject(frame, 60);
+	chip.emu.Inject(frame, 100);
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 64);
+	// over capacity
+	CHECK(drv.Receive(TestBuf, 80) == 0);
+	CHECK(st.rxFrames == 1 && st.rxBytes == 64 && st.rxDropped == 1);
+	CHECK(st.spiTransactions > 0);
+
+	RxFrame frames[] = { { TestBuf, sizeof(TestBuf), 0 }, { TestBuf, 10, 0 } };
+	chip.emu.Inject(frame, 60);
+	chip.emu.Inject(frame, 60);
+	CHECK(drv.ReceiveBatch(frames, 2) == 2);
+	CHECK(st.rxFrames == 2 && st.rxDropped == 2);
+
+	chip.emu.Inject(frame, 60);
+	CHECK(drv.BeginReceive() == 64);
+	drv.EndReceive();
+	CHECK(st.rxFrames == 3 && st.rxBytes == 192);
+
+	// CRC errors reach the driver only without ERXFCON.CRCEN
+	drv.SetRxFilter(0);
+	chip.emu.Inject(frame, 60, false);
+	drv.Receive(TestBuf, sizeof(TestBuf));
+	CHECK(st.rxCrcErrors == 1);
+
+	drv.ResetStats();
+	CHECK(st.rxFrames == 0 && st.spiTransactions == 0);
+}
+
+TEST(StatsTransmit)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	byte frame[100];
+	TestFrame(frame, sizeof(frame));
+	std::vector<byte> out;
+
+	drv.ResetStats();
+	auto& st = drv.Stats();
+
+	CHECK(drv.Transmit(frame, 60));
+	CHECK(drv.WaitTransmit() == TxDone);
+	CHECK(st.txFrames == 1 && st.txBytes >= 60 && st.txAborts == 0);
+
+	// aborted once, sent again by the retry
+	chip.emu.FailNextTransmit(true);
+	CHECK(drv.Transmit(frame, 60));
+	CHECK(drv.WaitTransmit() == TxDone);
+	CHECK(st.txFrames == 2 && st.txAborts == 1 && st.txLateCollisions == 1);
+}
+
+// RXERIF counted when EIR is read ( LineStatus )
+TEST(StatsOverflow)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	byte frame[100];
+	TestFrame(frame, sizeof(frame));
+
+	drv.ResetStats();
+
+	while (chip.emu.Inject(frame, 100));
+
+	delay(ETH_LINK_POLL_MS);
+	drv.LineStatus();
+	CHECK(drv.Stats().rxOverflows == 1);
+}
+
+// #12.1.2 - counted by a sketch only calling Receive, once
+TEST(StatsOverflowReceive)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	byte frame[100];
+	TestFrame(frame, sizeof(frame));
+
+	drv.ResetStats();
+
+	uint16_t stored = 0;
+	while (chip.emu.Inject(frame, 100)) ++stored;
+	CHECK(!chip.emu.Inject(frame, 100));
+
+	uint16_t received = 0;
+	while (drv.Receive(TestBuf, sizeof(TestBuf)) == 104) ++received;
+	CHECK(received == stored);
+	CHECK(drv.Stats().rxOverflows == 1);
+	CHECK(!(chip.emu.Peek(ETH_EIR) & ETH_EIR_RXERIF));
+
+	delay(ETH_LINK_POLL_MS);
+	drv.LineStatus();
+	CHECK(drv.Stats().rxOverflows == 1);
+
+	// no overflow : EIR not sampled again
+	CHECK(chip.emu.Inject(frame, 100));
+	CHECK(drv.Receive(TestBuf, sizeof(TestBuf)) == 104);
+	CHECK(drv.Stats().rxOverflows == 1);
+}
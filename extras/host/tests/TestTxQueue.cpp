@@ -0,0 +1,86 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+// queued frames sent in order, the queue outcome reported once
+TEST(TxQueueOrder)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	std::vector<byte> out;
+
+	byte f[100];
+	for (byte i = 0; i < BufferLayoutDefault.txSlots; ++i)
+	{
+		TestFrame(f, sizeof(f), i);
+		CHECK(drv.StartTransmit(f, sizeof(f)));
+	}
+	CHECK(drv.TxSlotsFree() == 0);
+
+	CHECK(drv.WaitTransmit() == TxDone);
+	CHECK(drv.PollTransmit() == TxIdle);
+
+	for (byte i = 0; i < BufferLayoutDefault.txSlots; ++i)
+		CHECK(chip.emu.PopTransmitted(out) && TestFrameIs(out.data(), sizeof(f), i));
+}
+
+// an async frame failed : a later synchronous Transmit reports its own
+// frame, the failure is left to PollTransmit
+TEST(TxQueueFailureNotShared)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	std::vector<byte> out;
+
+	byte f[60];
+	TestFrame(f, sizeof(f));
+
+	// first try and every retry aborted
+	chip.emu.FailNextTransmit(false, 1 + ETH_TX_RETRIES);
+	CHECK(drv.StartTransmit(f, sizeof(f)));
+	CHECK(drv.Transmit(f, sizeof(f)));
+	CHECK(chip.emu.PopTransmitted(out) && !chip.emu.PopTransmitted(out));
+
+	CHECK(drv.PollTransmit() == TxFailed);
+	CHECK(drv.PollTransmit() == TxIdle);
+
+	// next queue starts clean
+	CHECK(drv.StartTransmit(f, sizeof(f)));
+	CHECK(drv.WaitTransmit() == TxDone);
+
+	// synchronous failure
+	drv.ResetStats();
+	chip.emu.FailNextTransmit(false, 1 + ETH_TX_RETRIES);
+	CHECK(!drv.Transmit(f, sizeof(f)));
+	CHECK(drv.Transmit(f, sizeof(f)));
+	CHECK(drv.Stats().txAborts == 1 + ETH_TX_RETRIES);
+}
@@ -0,0 +1,81 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+namespace
+{
+
+	const byte Trailer[] PROGMEM = { 0xde, 0xad, 0xbe, 0xef };
+
+}
+
+// segments gathered in a single WBM, flash ones included
+TEST(TxSegmentsGather)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	std::vector<byte> out;
+
+	byte f[300];
+	TestFrame(f, sizeof(f));
+
+	TxSegment segs[] = { { f, 14, false }, { f + 14, 200, false }, { Trailer, sizeof(Trailer), true } };
+	CHECK(drv.Transmit(segs, 3));
+	CHECK(chip.emu.PopTransmitted(out) && out.size() == 218);
+	CHECK(memcmp(out.data(), f, 214) == 0 && memcmp(out.data() + 214, Trailer, 4) == 0);
+}
+
+// lengths summing over 64K must not wrap into a total that fits the slot
+TEST(TxSegmentsOverflow)
+{
+	TestChip chip;
+	Driver drv(RamData(TestMac, sizeof(TestMac)));
+	std::vector<byte> out;
+
+	byte f[60];
+	TestFrame(f, sizeof(f));
+
+	// 40000 + 25596 = 65596 : 60 in 16 bits ( buffers never read )
+	TxSegment segs[] = { { f, 40000, false }, { f, 25596, false } };
+	CHECK(drv.BeginTransmit());
+	CHECK(drv.WriteTransmit(segs, 2) == 0);
+	drv.EndTransmit();
+	CHECK(!drv.Transmit(segs, 2));
+
+	// over the slot by one byte
+	TxSegment big[] = { { f, ETH_TX_CAPACITY, false }, { f, 1, false } };
+	CHECK(!drv.Transmit(big, 2));
+
+	CHECK(!chip.emu.PopTransmitted(out));
+	CHECK(drv.Transmit(f, sizeof(f)));
+	CHECK(chip.emu.PopTransmitted(out) && out.size() == sizeof(f));
+}
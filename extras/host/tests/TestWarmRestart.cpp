@@ -0,0 +1,177 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "Test.h"
+
+using namespace SearchAThing::Arduino::Enc28j60;
+using namespace SearchAThing::Arduino::Enc28j60::Host;
+
+namespace
+{
+
+	byte group[] = { 0x01, 0x00, 0x5e, 0x00, 0x00, 0xfb };
+
+}
+
+// MCU reset with frames in the ring : kept with RestartWarmKeepRx, flushed
+// otherwise; neither counts as an rx reset
+TEST(WarmRestartRing)
+{
+	TestChip chip;
+	byte f[100];
+
+	auto a = new Driver(RamData(TestMac, sizeof(TestMac)));
+	CHECK(a->InitState() == InitReady);
+	for (byte i = 0; i < 5; ++i)
+	{
+		TestFrame(f, 60, i);
+		CHECK(chip.emu.Inject(f, 60));
+	}
+	CHECK(a->Receive(TestBuf, sizeof(TestBuf)) == 64 && TestFrameIs(TestBuf, 60, 0));
+	delete a;
+
+	{
+		Driver b(RamData(TestMac, sizeof(TestMac)), BufferLayoutDefault, RestartWarmKeepRx);
+		CHECK(b.InitState() == InitReady);
+		for (byte i = 1; i < 5; ++i)
+			CHECK(b.Receive(TestBuf, sizeof(TestBuf)) == 64 && TestFrameIs(TestBuf, 60, i));
+		CHECK(b.Receive(TestBuf, sizeof(TestBuf)) == 0);
+		CHECK(b.Stats().rxResets == 0);
+	}
+
+	for (byte i = 0; i < 3; ++i)
+	{
+		TestFrame(f, 60, i);
+		CHECK(chip.emu.Inject(f, 60));
+	}
+
+	Driver c(RamData(TestMac, sizeof(TestMac)));
+	CHECK(c.InitState() == InitReady);
+	CHECK(c.Receive(TestBuf, sizeof(TestBuf)) == 0);
+	CHECK(c.Stats().rxResets == 0);
+
+	TestFrame(f, 70, 9);
+	CHECK(chip.emu.Inject(f, 70));
+	CHECK(c.Receive(TestBuf, sizeof(TestBuf)) == 74 && TestFrameIs(TestBuf, 70, 9));
+}
+
+// #E14 - frames pending at the ring start : ERXRDPT on the ring end, the
+// next packet pointer back at ETH_RX_BEGIN
+TEST(WarmRestartRingStart)
+{
+	TestChip chip;
+	byte f[MAX_FRAME_LENGTH];
+
+	auto a = new Driver(RamData(TestMac, sizeof(TestMac)));
+	uint16_t ring = a->RxBufferSize();
+
+	// 60 bytes frames take 70 bytes of ring, the last one reaches its end
+	TestFrame(f, 60);
+	uint16_t pos = 0;
+	for (; ring - pos > 1000; pos += 70)
+	{
+		CHECK(chip.emu.Inject(f, 60));
+		CHECK(a->Receive(TestBuf, sizeof(TestBuf)) == 64);
+	}
+	uint16_t last = ring - pos - 6 - 4;
+	TestFrame(f, last);
+	CHECK(chip.emu.Inject(f, last));
+	CHECK(a->Receive(TestBuf, sizeof(TestBuf)) == last + 4);
+
+	for (byte i = 0; i < 3; ++i)
+	{
+		TestFrame(f, 60, i);
+		CHECK(chip.emu.Inject(f, 60));
+	}
+	delete a;
+
+	Driver b(RamData(TestMac, sizeof(TestMac)), BufferLayoutDefault, RestartWarmKeepRx);
+	CHECK(b.InitState() == InitReady);
+	for (byte i = 0; i < 3; ++i)
+		CHECK(b.Receive(TestBuf, sizeof(TestBuf)) == 64 && TestFrameIs(TestBuf, 60, i));
+	CHECK(b.Receive(TestBuf, sizeof(TestBuf)) == 0);
+	CHECK(b.Stats().rxResets == 0);
+}
+
+// no reset wait ( #E2 ), tx logic usable right away
+TEST(WarmRestartTiming)
+{
+	TestChip chip;
+	byte f[60];
+	TestFrame(f, sizeof(f), 0);
+
+	auto t0 = micros();
+	{
+		Driver a(RamData(TestMac, sizeof(TestMac)), BufferLayoutDefault, RestartCold);
+		CHECK(micros() - t0 >= 1000);
+		CHECK(a.StartTransmit(f, sizeof(f)));
+	}
+
+	t0 = micros();
+	Driver b(RamData(TestMac, sizeof(TestMac)));
+	CHECK(b.InitState() == InitReady);
+	CHECK(micros() - t0 < 1000);
+
+	std::vector<byte> out;
+	while (chip.emu.PopTransmitted(out));
+	CHECK(b.Transmit(f, sizeof(f)));
+	CHECK(chip.emu.PopTransmitted(out) && out.size() == sizeof(f));
+}
+
+// joined groups of the previous run dropped, filter otherwise kept
+TEST(WarmRestartMulticast)
+{
+	TestChip chip;
+
+	auto a = new Driver(RamData(TestMac, sizeof(TestMac)));
+	CHECK(a->JoinMulticast(group));
+	CHECK(a->RxFilter() & ETH_ERXFCON_HTEN);
+	auto filter = a->RxFilter() & ~ETH_ERXFCON_HTEN;
+	delete a;
+
+	Driver b(RamData(TestMac, sizeof(TestMac)));
+	CHECK(b.RxFilter() == filter);
+	CHECK(!(chip.emu.Peek(ETH_ERXFCON) & ETH_ERXFCON_HTEN));
+	for (byte i = 0; i < 8; ++i) CHECK(chip.emu.Peek(ETH_EHT0 + i) == 0);
+}
+
+// script replayed : the one of this run wins over the previous one
+TEST(WarmRestartScript)
+{
+	TestChip chip;
+
+	delete new Driver(RamData(TestMac, sizeof(TestMac)));
+	CHECK(chip.emu.Peek(ETH_MACON3) & ETH_MACON3_FULDPX);
+
+	Driver b(RamData(TestMac, sizeof(TestMac)), BufferLayoutDefault, RestartWarm, InitScriptHalfDuplex);
+	CHECK(b.InitState() == InitReady);
+	CHECK(b.Stats().rxResets == 0);
+	CHECK(!(chip.emu.Peek(ETH_MACON3) & ETH_MACON3_FULDPX));
+	CHECK(chip.emu.Peek(ETH_MACON4) & ETH_MACON4_DEFER);
+	CHECK(chip.emu.PeekPhy(ETH_PHCON1) == 0);
+}
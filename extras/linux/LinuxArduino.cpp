@@ -0,0 +1,108 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Arduino core for a Linux host reaching the controller through
+// SpidevTransport : the extras/host declarations implemented on the real
+// monotonic clock instead of the emulator one ( link in place of
+// HostArduino.cpp ). Pins and interrupts aren't wired : CS is driven by
+// spidev and the driver runs in polling mode.
+
+#include "arduino.h"
+#include "SPI.h"
+
+#include <time.h>
+#include <errno.h>
+
+SPIClass SPI;
+
+namespace
+{
+
+	uint64_t MonotonicNanos()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+
+		return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	}
+
+	// millis and micros count from startup as on the board
+	const uint64_t startNanos = MonotonicNanos();
+
+	void SleepNanos(uint64_t ns)
+	{
+		timespec ts;
+		ts.tv_sec = ns / 1000000000ULL;
+		ts.tv_nsec = ns % 1000000000ULL;
+
+		while (nanosleep(&ts, &ts) < 0 && errno == EINTR);
+	}
+
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+}
+
+int digitalRead(uint8_t pin)
+{
+	return HIGH;
+}
+
+void attachInterrupt(uint8_t interruptNum, void(*userFunc)(void), int mode)
+{
+}
+
+void detachInterrupt(uint8_t interruptNum)
+{
+}
+
+unsigned long millis() { return (unsigned long)((MonotonicNanos() - startNanos) / 1000000); }
+
+unsigned long micros() { return (unsigned long)((MonotonicNanos() - startNanos) / 1000); }
+
+void delay(unsigned long ms) { SleepNanos((uint64_t)ms * 1000000); }
+
+void delayMicroseconds(unsigned int us) { SleepNanos((uint64_t)us * 1000); }
+
+//--
+
+// ArduinoSpiTransport ( the driver default ) isn't usable here
+
+void SPIClass::begin() { }
+
+void SPIClass::end() { }
+
+void SPIClass::beginTransaction(SPISettings settings) { }
+
+void SPIClass::endTransaction() { }
+
+uint8_t SPIClass::transfer(uint8_t data) { return 0xFF; }
+
+uint16_t SPIClass::transfer16(uint16_t data) { return 0xFFFF; }
+
+void SPIClass::transfer(void *buf, size_t count) { memset(buf, 0xFF, count); }
@@ -0,0 +1,208 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#include "SpidevTransport.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			SpidevTransport::SpidevTransport(const char *_device, uint32_t _clock)
+			{
+				device = _device;
+				clock = _clock;
+			}
+
+			SpidevTransport::~SpidevTransport()
+			{
+				End();
+			}
+
+			int SpidevTransport::SysOpen(const char *path, int flags)
+			{
+				return open(path, flags);
+			}
+
+			int SpidevTransport::SysIoctl(int _fd, unsigned long request, void *arg)
+			{
+				return ioctl(_fd, request, arg);
+			}
+
+			int SpidevTransport::SysClose(int _fd)
+			{
+				return close(_fd);
+			}
+
+			bool SpidevTransport::IsOpen() const { return fd >= 0; }
+
+			void SpidevTransport::End()
+			{
+				queued.clear();
+				if (fd < 0) return;
+
+				SysClose(fd);
+				fd = -1;
+			}
+
+			uint32_t SpidevTransport::Errors() const { return errors; }
+
+			void SpidevTransport::Begin()
+			{
+				if (fd >= 0) return;
+
+				fd = SysOpen(device, O_RDWR);
+				if (fd < 0)
+				{
+					++errors;
+					return;
+				}
+
+				// #4 - mode 0,0, MSB first
+				uint8_t mode = SPI_MODE_0;
+				uint8_t bits = 8;
+
+				if (SysIoctl(fd, SPI_IOC_WR_MODE, &mode) < 0 ||
+					SysIoctl(fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+					SysIoctl(fd, SPI_IOC_WR_MAX_SPEED_HZ, &clock) < 0)
+				{
+					++errors;
+					End();
+				}
+			}
+
+			// spidev bufsiz module parameter default : max bytes of a message
+#define SPIDEV_BUFSIZ 4096
+
+			bool SpidevTransport::Flush(const byte *tx, byte *rx, uint32_t len, bool keepCs)
+			{
+				spi_ioc_transfer tr[2];
+				memset(tr, 0, sizeof(tr));
+				byte n = 0;
+
+				if (!queued.empty())
+				{
+					tr[n].tx_buf = (uintptr_t)queued.data();
+					tr[n].len = queued.size();
+					++n;
+				}
+
+				// an empty transfer alone still releases CS
+				if (len > 0 || n == 0)
+				{
+					tr[n].tx_buf = (uintptr_t)tx;
+					tr[n].rx_buf = (uintptr_t)rx;
+					tr[n].len = len;
+					++n;
+				}
+
+				for (byte i = 0; i < n; ++i)
+				{
+					tr[i].speed_hz = clock;
+					tr[i].bits_per_word = 8;
+				}
+				// CS held between the transfers of a message
+				tr[n - 1].cs_change = keepCs ? 1 : 0;
+
+				bool ok = fd >= 0 && SysIoctl(fd, n == 1 ? SPI_IOC_MESSAGE(1) : SPI_IOC_MESSAGE(2), tr) >= 0;
+				queued.clear();
+
+				if (ok) return true;
+
+				++errors;
+				if (rx != NULL) memset(rx, 0xFF, len);
+
+				return false;
+			}
+
+			void SpidevTransport::Queue(const byte *data, uint32_t len)
+			{
+				if (queued.size() + len > SPIDEV_BUFSIZ) Flush(NULL, NULL, 0, true);
+
+				if (len > SPIDEV_BUFSIZ)
+					Flush(data, NULL, len, true);
+				else
+					queued.insert(queued.end(), data, data + len);
+			}
+
+			// CS asserted by the first message
+			void SpidevTransport::Select()
+			{
+			}
+
+			// queued bytes or an empty message releasing CS
+			void SpidevTransport::Deselect()
+			{
+				Flush(NULL, NULL, 0, false);
+			}
+
+			byte SpidevTransport::Transfer(byte data)
+			{
+				byte res = 0;
+				if (queued.size() + 1 > SPIDEV_BUFSIZ) Flush(NULL, NULL, 0, true);
+				Flush(&data, &res, 1, true);
+
+				return res;
+			}
+
+			void SpidevTransport::Write(byte data)
+			{
+				Queue(&data, 1);
+			}
+
+			void SpidevTransport::ReadBlock(byte *data, uint16_t len)
+			{
+				if (queued.size() + len > SPIDEV_BUFSIZ) Flush(NULL, NULL, 0, true);
+				Flush(NULL, data, len, true);
+			}
+
+			void SpidevTransport::WriteBlock(const byte *data, uint16_t len)
+			{
+				Queue(data, len);
+			}
+
+			// no separate flash address space
+			void SpidevTransport::WriteBlock_P(const byte *data, uint16_t len)
+			{
+				Queue(data, len);
+			}
+
+		}
+
+	}
+
+}
@@ -0,0 +1,104 @@
+/*
+* The MIT License(MIT)
+* Copyright(c) 2016 Lorenzo Delana, https://searchathing.com
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+// Datasheet references
+// --------------------
+// # are relative to the DS39662E
+// #E are relative to the DS80349C
+
+#ifndef _SEARCHATHING_ARDUINO_ENC28J60_LINUX_SPIDEVTRANSPORT_H
+#define _SEARCHATHING_ARDUINO_ENC28J60_LINUX_SPIDEVTRANSPORT_H
+
+#include "SpiTransport.h"
+
+#include <vector>
+
+namespace SearchAThing
+{
+
+	namespace Arduino
+	{
+
+		namespace Enc28j60
+		{
+
+			// Linux spidev ( /dev/spidevB.C ) : bytes whose read back isn't
+			// needed ( Write, WriteBlock ) are queued and sent in the same
+			// SPI_IOC_MESSAGE as the next Transfer or ReadBlock, or on Deselect,
+			// so that a register write is a single ioctl. cs_change on the last
+			// transfer of a message keeps CS asserted up to Deselect ( requires
+			// a controller honouring cs_change )
+			class SpidevTransport : public SpiTransport
+			{
+
+				const char *device;
+				uint32_t clock;
+				int fd = -1;
+				uint32_t errors = 0;
+				std::vector<byte> queued;
+
+				// queued bytes then len bytes ( tx NULL sends zeros, rx NULL
+				// discards ) in one message; CS left asserted after it if keepCs.
+				// On failure rx is filled with 0xFF as from an idle bus and the
+				// error counted
+				bool Flush(const byte *tx, byte *rx, uint32_t len, bool keepCs);
+				void Queue(const byte *data, uint32_t len);
+
+			protected:
+				// system calls on the device, overridden to fake it
+				virtual int SysOpen(const char *path, int flags);
+				virtual int SysIoctl(int fd, unsigned long request, void *arg);
+				virtual int SysClose(int fd);
+
+			public:
+				SpidevTransport(const char *_device = "/dev/spidev0.0", uint32_t _clock = ETH_SPI_CLOCK);
+				// closes through the base SysClose : a class faking the system
+				// calls calls End from its own destructor
+				virtual ~SpidevTransport();
+
+				// false if the device can't be opened or configured
+				bool IsOpen() const;
+				// close the device ( reopened by Begin )
+				void End();
+
+				// failed opens and messages since construction
+				uint32_t Errors() const;
+
+				void Begin();
+				void Select();
+				void Deselect();
+				byte Transfer(byte data);
+				void Write(byte data);
+				void ReadBlock(byte *data, uint16_t len);
+				void WriteBlock(const byte *data, uint16_t len);
+				void WriteBlock_P(const byte *data, uint16_t len);
+
+			};
+
+		}
+
+	}
+
+}
+
+#endif